@@ -1,47 +1,190 @@
-/////////////////////////////////////////////////////////////////////
-// Compute Levenshtein Distance
-// Martin Ettl, 2012-10-05
- // Edit or levenshtein distance
-
-size_t uiLevenshteinDistance(const std::string &s1, const std::string &s2)
-{
-  const size_t m(s1.size());
-  const size_t n(s2.size());
- 
-  if( m==0 ) return n;
-  if( n==0 ) return m;
- 
-  size_t *costs = new size_t[n + 1];
- 
-  for( size_t k=0; k<=n; k++ ) costs[k] = k;
- 
-  size_t i = 0;
-  for ( std::string::const_iterator it1 = s1.begin(); it1 != s1.end(); ++it1, ++i )
-  {
-    costs[0] = i+1;
-    size_t corner = i;
- 
-    size_t j = 0;
-    for ( std::string::const_iterator it2 = s2.begin(); it2 != s2.end(); ++it2, ++j )
-    {
-      size_t upper = costs[j+1];
-      if( *it1 == *it2 )
-      {
-		  costs[j+1] = corner;
-	  }
-      else
-	  {
-		size_t t(upper<corner?upper:corner);
-        costs[j+1] = (costs[j]<t?costs[j]:t)+1;
-	  }
- 
-      corner = upper;
-    }
-  }
- 
-  size_t result = costs[n];
-  delete [] costs;
- 
-  return result;
-}
- 
+#ifndef __utilsToStudents_H
+#define __utilsToStudents_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/////////////////////////////////////////////////////////////////////
+// Compute Levenshtein Distance
+// Martin Ettl, 2012-10-05
+ // Edit or levenshtein distance
+
+inline size_t uiLevenshteinDistance(const std::string &s1, const std::string &s2)
+{
+  const size_t m(s1.size());
+  const size_t n(s2.size());
+ 
+  if( m==0 ) return n;
+  if( n==0 ) return m;
+ 
+  size_t *costs = new size_t[n + 1];
+ 
+  for( size_t k=0; k<=n; k++ ) costs[k] = k;
+ 
+  size_t i = 0;
+  for ( std::string::const_iterator it1 = s1.begin(); it1 != s1.end(); ++it1, ++i )
+  {
+    costs[0] = i+1;
+    size_t corner = i;
+ 
+    size_t j = 0;
+    for ( std::string::const_iterator it2 = s2.begin(); it2 != s2.end(); ++it2, ++j )
+    {
+      size_t upper = costs[j+1];
+      if( *it1 == *it2 )
+      {
+		  costs[j+1] = corner;
+	  }
+      else
+	  {
+		size_t t(upper<corner?upper:corner);
+        costs[j+1] = (costs[j]<t?costs[j]:t)+1;
+	  }
+ 
+      corner = upper;
+    }
+  }
+ 
+  size_t result = costs[n];
+  delete [] costs;
+ 
+  return result;
+}
+ 
+
+/////////////////////////////////////////////////////////////////////
+// Bit-parallel Levenshtein distance
+// Myers (1999) with the multi-word blocks of Hyyro (2003). Each
+// column of the DP matrix is kept as two bit vectors of vertical
+// +1/-1 deltas, so one text character costs a few word operations
+// per 64 pattern characters instead of one cell per character.
+
+// Advances one 64 row block of the column by a text character and
+// returns the horizontal delta leaving its last row (+1, 0 or -1).
+// hin is the delta entering its first row from the block above.
+inline int iLevenshteinAdvanceBlock(uint64_t &pv, uint64_t &mv, uint64_t eq, int hin, uint64_t last)
+{
+  const uint64_t xv = eq | mv;
+  if( hin < 0 ) eq |= 1;
+  const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+  uint64_t ph = mv | ~(xh | pv);
+  uint64_t mh = pv & xh;
+
+  int hout = 0;
+  if( ph & last ) hout = 1;
+  else if( mh & last ) hout = -1;
+
+  ph <<= 1;
+  mh <<= 1;
+  if( hin < 0 ) mh |= 1;
+  else if( hin > 0 ) ph |= 1;
+
+  pv = mh | ~(xv | ph);
+  mv = ph & xv;
+
+  return hout;
+}
+
+// Distance from a pattern, given as the match masks of each byte
+// (peq[c * words + b] has bit i set when pattern[64 * b + i] == c),
+// to a text. Stops once the distance can no longer be maxDistance or
+// less and returns maxDistance + 1. pv and mv are scratch space.
+inline size_t uiLevenshteinMyers(const uint64_t *peq, size_t m, const std::string &text, size_t maxDistance,
+  std::vector<uint64_t> &pv, std::vector<uint64_t> &mv)
+{
+  const size_t n(text.size());
+  const size_t words((m + 63) / 64);
+  const uint64_t last(uint64_t(1) << ((m - 1) % 64));
+
+  if( m==0 ) return n <= maxDistance ? n : maxDistance + 1;
+  if( (n > m ? n - m : m - n) > maxDistance ) return maxDistance + 1;
+
+  pv.assign(words, ~uint64_t(0));
+  mv.assign(words, 0);
+  size_t score = m;
+
+  for ( size_t j = 0; j < n; ++j )
+  {
+    const uint64_t *eq = peq + (unsigned char)text[j] * words;
+
+    // The top row is D[0][j] = j so +1 enters the first block
+    int hin = 1;
+    for ( size_t b = 0; b + 1 < words; ++b )
+      hin = iLevenshteinAdvanceBlock(pv[b], mv[b], eq[b], hin, uint64_t(1) << 63);
+    hin = iLevenshteinAdvanceBlock(pv[words - 1], mv[words - 1], eq[words - 1], hin, last);
+    score += hin;
+
+    // The last row can fall by at most one per remaining character
+    if( score > maxDistance && score - maxDistance > n - j - 1 ) return maxDistance + 1;
+  }
+
+  return score <= maxDistance ? score : maxDistance + 1;
+}
+
+// Fills the match masks of a pattern for uiLevenshteinMyers
+inline void vLevenshteinPattern(const std::string &pattern, std::vector<uint64_t> &peq)
+{
+  const size_t words((pattern.size() + 63) / 64);
+
+  peq.assign(256 * (words ? words : 1), 0);
+  for ( size_t i = 0; i < pattern.size(); ++i )
+    peq[(unsigned char)pattern[i] * words + i / 64] |= uint64_t(1) << (i % 64);
+}
+
+// Edit distance, or maxDistance + 1 when it is more than maxDistance
+inline size_t uiLevenshteinDistanceBounded(const std::string &s1, const std::string &s2, size_t maxDistance)
+{
+  // The shorter string is the pattern so the column needs fewer words
+  const std::string &pattern(s1.size() <= s2.size() ? s1 : s2);
+  const std::string &text(s1.size() <= s2.size() ? s2 : s1);
+  std::vector<uint64_t> pv, mv;
+
+  if( pattern.size() <= 64 )
+  {
+    // Only the entries of text characters are ever read, so only
+    // they are cleared rather than all 256
+    uint64_t peq[256];
+    for ( size_t j = 0; j < text.size(); ++j ) peq[(unsigned char)text[j]] = 0;
+    for ( size_t i = 0; i < pattern.size(); ++i ) peq[(unsigned char)pattern[i]] |= uint64_t(1) << i;
+
+    if( pattern.empty() ) return text.size() <= maxDistance ? text.size() : maxDistance + 1;
+    if( text.size() - pattern.size() > maxDistance ) return maxDistance + 1;
+
+    uint64_t pv1 = ~uint64_t(0), mv1 = 0;
+    const uint64_t last(uint64_t(1) << (pattern.size() - 1));
+    size_t score = pattern.size();
+    for ( size_t j = 0; j < text.size(); ++j )
+    {
+      score += iLevenshteinAdvanceBlock(pv1, mv1, peq[(unsigned char)text[j]], 1, last);
+      if( score > maxDistance && score - maxDistance > text.size() - j - 1 ) return maxDistance + 1;
+    }
+    return score <= maxDistance ? score : maxDistance + 1;
+  }
+
+  std::vector<uint64_t> peq;
+  vLevenshteinPattern(pattern, peq);
+  return uiLevenshteinMyers(peq.data(), pattern.size(), text, maxDistance, pv, mv);
+}
+
+// Same result as uiLevenshteinDistance
+inline size_t uiLevenshteinDistanceFast(const std::string &s1, const std::string &s2)
+{
+  return uiLevenshteinDistanceBounded(s1, s2, s1.size() + s2.size());
+}
+
+// Edit distance from one query to each of many candidates, such as
+// every word of a vocabulary. The query's masks are built once and
+// candidates further than maxDistance get maxDistance + 1.
+inline void vLevenshteinDistances(const std::string &query, const std::vector<std::string> &candidates,
+  std::vector<size_t> &distances, size_t maxDistance = SIZE_MAX - 1)
+{
+  std::vector<uint64_t> peq, pv, mv;
+
+  vLevenshteinPattern(query, peq);
+  distances.resize(candidates.size());
+  for ( size_t c = 0; c < candidates.size(); ++c )
+    distances[c] = uiLevenshteinMyers(peq.data(), query.size(), candidates[c], maxDistance, pv, mv);
+}
+
+#endif
@@ -0,0 +1,149 @@
+/**************************************************************
+* Compares the accuracy of trigram counts held in count-min
+* sketches of several sizes against exact counts, and the
+* perplexity of an add delta model built on each relative
+* to one built on the exact counts
+*
+* Build: g++ -O2 -std=c++11 -pthread -I../src sketch_benchmark.cpp ../src/[a-z]*.cpp -o sketch_benchmark
+* Usage: ./sketch_benchmark [numTokens] [vocabularySize]
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#include <cstdio>  //printf()
+#include <cstdlib> //atoi()
+#include <cmath>   //exp()
+#include <random>  //std::mt19937
+#include <string>  //std::string   std::to_string()
+#include <vector>  //std::vector
+
+#include "ad_document.t.h"
+
+#define SKETCH_LENGTH 3
+#define SENTENCE_LENGTH 20
+#define BENCHMARK_DELTA 0.1
+#define HEAVY_COUNT 64
+#define MAX_HEAVY 4096
+
+using namespace nlp;
+
+//Creates a stream of tokens following a zipfian distrubution
+int makeTokens(int numTokens_in, int vocabulary_in, unsigned int seed_in, std::vector<std::string> * location_in) {
+  std::vector<double> weights;
+  int wordIterator;
+
+  for (wordIterator = 0; wordIterator < vocabulary_in; ++wordIterator) {
+    weights.push_back(1.0 / (wordIterator + 1));
+  }
+
+  std::mt19937 generator(seed_in);
+  std::discrete_distribution<int> distrubution(weights.begin(), weights.end());
+  for (wordIterator = 0; wordIterator < numTokens_in; ++wordIterator) {
+    location_in->push_back(std::to_string(distrubution(generator)));
+  }
+
+  return 0;
+}
+
+//Finds the perplexity of a model over text split into sentences of SENTENCE_LENGTH tokens
+double perplexity(ADDocument<std::string> * model_in, std::vector<std::string> * tokens_in, int vocabulary_in) {
+  double logTotal;
+  int tokenIterator;
+
+  logTotal = 0;
+  for (tokenIterator = 0; tokenIterator + SENTENCE_LENGTH <= (int) tokens_in->size(); tokenIterator += SENTENCE_LENGTH) {
+    std::vector<std::string> sentence(tokens_in->begin() + tokenIterator, tokens_in->begin() + tokenIterator + SENTENCE_LENGTH);
+    logTotal += model_in->logSentenceProbability(SKETCH_LENGTH, &sentence, vocabulary_in);
+  }
+
+  return exp(-logTotal / (tokens_in->size() / SENTENCE_LENGTH * SENTENCE_LENGTH));
+}
+
+int main(int argc, char ** argv) {
+  std::vector<std::string> train;
+  std::vector<std::string> test;
+  std::vector<int> lengths;
+  std::vector<TokenId> ids;
+  Lexicon<std::string> lexicon;
+  NgramTable<int> table(SKETCH_LENGTH);
+  SketchOptions options;
+  SketchStats stats;
+  size_t exactBytes;
+  int numTokens;
+  int vocabulary;
+  int divisor;
+  int heavy;
+  int tokenIterator;
+  long long numWithin;
+  long long numChecked;
+  double meanSeen, meanUnseen;
+  double exactPerplexity;
+  unsigned int maxError;
+
+  numTokens = argc > 1 ? atoi(argv[1]) : 2000000;
+  vocabulary = argc > 2 ? atoi(argv[2]) : 50000;
+  makeTokens(numTokens, vocabulary, 1, &train);
+  makeTokens(numTokens / 10, vocabulary, 2, &test);
+  for (tokenIterator = 1; tokenIterator <= SKETCH_LENGTH; ++tokenIterator) {
+    lengths.push_back(tokenIterator);
+  }
+
+  //The exact counts, and the memory a table of the sketched length needs to hold them
+  ADDocument<std::string> exact(&train, &lengths, BENCHMARK_DELTA);
+  lexicon.addTokens(&train, &ids);
+  for (tokenIterator = 0; tokenIterator + SKETCH_LENGTH <= numTokens; ++tokenIterator) {
+    *table.insert(&ids[tokenIterator]) += 1;
+  }
+  exactBytes = table.memoryUsage();
+
+  printf("%d tokens, vocabulary of %d, %d distinct %d-grams in %zu bytes\n", numTokens, vocabulary, table.size(), SKETCH_LENGTH, exactBytes);
+  exactPerplexity = perplexity(&exact, &test, exact.numDistinctNgrams(1));
+  printf("%-10s %6s %5s %10s %10s %10s %9s %10s %10s %10s\n", "bytes", "heavy", "rows", "bound", "seen err", "unseen err", "max err", "in bound", "distinct", "ppl/exact");
+
+  //Each sketch is a fraction of the exact table, with and without an exact table of heavy hitters
+  for (divisor = 64; divisor >= 1; divisor /= 4) {
+    for (heavy = 0; heavy <= 1; ++heavy) {
+      options.numBytes = exactBytes / divisor;
+      options.depth = SKETCH_DEPTH;
+      options.exactLength = SKETCH_LENGTH - 1;
+      options.heavyCount = heavy > 0 ? HEAVY_COUNT : 0;
+      options.maxHeavy = MAX_HEAVY;
+      ADDocument<std::string> sketched(&train, &lengths, &options, BENCHMARK_DELTA);
+      sketched.getSketchStats(SKETCH_LENGTH, &stats);
+
+      //Error of every trigram occurance of the training text, which weighs frequent trigrams by their count
+      meanSeen = 0;
+      maxError = 0;
+      numWithin = 0;
+      numChecked = 0;
+      for (tokenIterator = 0; tokenIterator + SKETCH_LENGTH <= numTokens; ++tokenIterator) {
+        unsigned int error = sketched.countNgram(&train[tokenIterator], SKETCH_LENGTH) - exact.countNgram(&train[tokenIterator], SKETCH_LENGTH);
+        meanSeen += error;
+        maxError = error > maxError ? error : maxError;
+        numWithin += error <= stats.errorBound ? 1 : 0;
+        ++numChecked;
+      }
+      meanSeen /= numChecked;
+
+      //Trigrams of the test text that were never counted should estimate to 0
+      meanUnseen = 0;
+      numChecked = 0;
+      for (tokenIterator = 0; tokenIterator + SKETCH_LENGTH <= (int) test.size(); ++tokenIterator) {
+        if (exact.countNgram(&test[tokenIterator], SKETCH_LENGTH) == 0) {
+          meanUnseen += sketched.countNgram(&test[tokenIterator], SKETCH_LENGTH);
+          ++numChecked;
+        }
+      }
+      meanUnseen = numChecked == 0 ? 0 : meanUnseen / numChecked;
+
+      printf("%-10zu %6d %5d %10.1f %10.3f %10.3f %9u %9.2f%% %10d %10.3f\n", stats.numBytes, stats.numHeavy, stats.depth, stats.errorBound, meanSeen, meanUnseen,
+        maxError, 100.0 * numWithin / (numTokens - SKETCH_LENGTH + 1), sketched.numDistinctNgrams(SKETCH_LENGTH), perplexity(&sketched, &test, exact.numDistinctNgrams(1)) / exactPerplexity);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/**************************************************************
+* Compares building and querying ngram counts stored in an
+* unordered_map of vectors against an NgramTable
+*
+* Build: g++ -O2 -std=c++11 -I../src table_benchmark.cpp -o table_benchmark
+* Usage: ./table_benchmark [numTokens] [vocabularySize]
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#include <cstdio>        //printf()
+#include <cstdlib>       //atoi()
+#include <chrono>        //std::chrono
+#include <random>        //std::mt19937
+#include <vector>        //std::vector
+#include <unordered_map> //std::unordered_map
+
+#include "VectorHash.h"
+#include "ngram_table.t.h"
+
+#define MAX_BENCHMARK_LENGTH 5
+
+using namespace nlp;
+
+//Finds the number of milliseconds since the specified time
+double elapsed(std::chrono::steady_clock::time_point start_in) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_in).count();
+}
+
+//Creates a stream of token identifiers following a zipfian distrubution
+int makeTokens(int numTokens_in, int vocabulary_in, unsigned int seed_in, std::vector<TokenId> * location_in) {
+  std::vector<double> weights;
+  int wordIterator;
+
+  for (wordIterator = 0; wordIterator < vocabulary_in; ++wordIterator) {
+    weights.push_back(1.0 / (wordIterator + 1));
+  }
+
+  std::mt19937 generator(seed_in);
+  std::discrete_distribution<int> distrubution(weights.begin(), weights.end());
+  for (wordIterator = 0; wordIterator < numTokens_in; ++wordIterator) {
+    location_in->push_back(distrubution(generator));
+  }
+
+  return 0;
+}
+
+int main(int argc, char ** argv) {
+  std::vector<TokenId> train;
+  std::vector<TokenId> test;
+  int numTokens;
+  int vocabulary;
+  int length;
+  int tokenIterator;
+  long long found;
+  double mapBuild, mapLookup, tableBuild, tableLookup;
+
+  numTokens = argc > 1 ? atoi(argv[1]) : 2000000;
+  vocabulary = argc > 2 ? atoi(argv[2]) : 50000;
+  makeTokens(numTokens, vocabulary, 1, &train);
+  makeTokens(numTokens, vocabulary, 2, &test);
+
+  printf("%d tokens, vocabulary of %d\n", numTokens, vocabulary);
+  printf("%-6s %10s %10s %10s %10s %10s %12s\n", "length", "distinct", "map build", "table build", "map find", "table find", "table bytes");
+
+  for (length = 1; length <= MAX_BENCHMARK_LENGTH; ++length) {
+    std::unordered_map<std::vector<TokenId>, int> map;
+    NgramTable<int> table(length);
+    std::chrono::steady_clock::time_point start;
+
+    //Count every ngram with the map
+    start = std::chrono::steady_clock::now();
+    for (tokenIterator = 0; tokenIterator + length <= numTokens; ++tokenIterator) {
+      std::vector<TokenId> key(train.begin() + tokenIterator, train.begin() + tokenIterator + length);
+      map[key] += 1;
+    }
+    mapBuild = elapsed(start);
+
+    //Count every ngram with the table
+    start = std::chrono::steady_clock::now();
+    for (tokenIterator = 0; tokenIterator + length <= numTokens; ++tokenIterator) {
+      *table.insert(&train[tokenIterator]) += 1;
+    }
+    tableBuild = elapsed(start);
+
+    //Look up every ngram of unseen text with the map
+    found = 0;
+    start = std::chrono::steady_clock::now();
+    for (tokenIterator = 0; tokenIterator + length <= numTokens; ++tokenIterator) {
+      std::vector<TokenId> key(test.begin() + tokenIterator, test.begin() + tokenIterator + length);
+      auto result = map.find(key);
+      found += result == map.end() ? 0 : result->second;
+    }
+    mapLookup = elapsed(start);
+
+    //Look up every ngram of unseen text with the table
+    start = std::chrono::steady_clock::now();
+    for (tokenIterator = 0; tokenIterator + length <= numTokens; ++tokenIterator) {
+      int * result = table.find(&test[tokenIterator]);
+      found -= result == NULL ? 0 : *result;
+    }
+    tableLookup = elapsed(start);
+
+    //Both structures must agree on every count
+    if (found != 0 || (int) map.size() != table.size()) {
+      printf("length %d: map and table disagree\n", length);
+      return 1;
+    }
+
+    printf("%-6d %10d %9.1fms %9.1fms %9.1fms %9.1fms %12zu\n", length, table.size(), mapBuild, tableBuild, mapLookup, tableLookup, table.memoryUsage());
+  }
+
+  return 0;
+}
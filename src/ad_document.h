@@ -5,8 +5,8 @@
 * Created By: Nick DelBen
 * Created On: March 7, 2015
 *
-* Last Edited: March 7, 2015
-*   - Created initially
+* Last Edited: October 18, 2026
+*   - Added quantizing the probabilities of the stored ngrams
 **************************************************************/
 
 #ifndef _H_AD_DOCUMENT
@@ -24,6 +24,28 @@ namespace nlp {
   private:
     /* The delta value to be used for this model */
     double delta;
+
+    /* Vocabulary sizes with cached delta masses, the number of distinct ngrams of each length when buildMasses was called */
+    std::vector<int> massVocabularies;
+
+    /* Delta times each cached vocabulary to the power of each ngram length, masses[i][length - 1] */
+    std::vector<std::vector<double>> masses;
+
+    /******************
+    * Finds the probability mass delta adds to every ngram of a length, from the cache when it holds the vocabulary
+    * @param  vocabulary_in size of the vocabulary
+    * @param  length_in     length of the ngrams
+    * @return delta times the vocabulary to the power of the length
+    ******************/
+    double deltaMass(int vocabulary_in, int length_in);
+
+    /******************
+    * Computes the probability of the token stored just after a state's context given the context
+    * @param  state_in      state holding the context and the token
+    * @param  vocabulary_in size of the vocabulary
+    * @return probability of the token
+    ******************/
+    double nextProbability(ScorerState * state_in, int vocabulary_in);
   public:
     /*******************
     * Creates a new instance of ADDocument finding all the ngrams 
@@ -47,6 +69,51 @@ namespace nlp {
     * @param gramLenghts_in the lengths to construct the dictionaries from
     *******************/
     ADDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument finding all the ngrams of the sizes specified in the
+    * input vector, counted on several threads
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param numThreads_in  number of threads to count with
+    * @param delta_in       delta value of the model
+    *******************/
+    ADDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument from tokens that have already been given identifiers
+    * @param lexicon_in     lexicon the identifiers were taken from
+    * @param tokens_in      identifiers of the tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    *******************/
+    ADDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument by counting ngrams as the tokens are read from a source
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param keepTokens_in  if this is >0 the tokens are also stored so more lengths can be read later
+    *******************/
+    ADDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument that counts the longer lengths in count-min sketches as
+    * Document does, so their probabilities come from estimated counts
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    ADDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument that counts the longer lengths in count-min sketches as
+    * the tokens are read from a source, which is not kept
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    ADDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, double delta_in);
+    /*******************
+    * Creates a new instance of ADDocument that queries its counts directly from a mapped
+    * model file written by ADDocument::saveModel
+    * @param model_in model file to query the counts from
+    *******************/
+    ADDocument(ModelFile * model_in);
 
     //Default constructor and destructor
     ADDocument();
@@ -91,6 +158,79 @@ namespace nlp {
     ******************/
     double logSentenceProbability(int length_in, std::vector<Type> * sentence_in, int vocabulary_in);
 
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state.
+    * The vocabulary is the number of distinct ngrams of the specified length as in logSentenceProbability
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  token_in  token to score
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, Type * token_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  id_in     identifier of the token to score in the lexicon of the document
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, TokenId id_in);
+
+    /******************
+    * Writes the document and its delta value to a model file
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written or the document counts with sketches
+    ******************/
+    int saveModel(std::string fileName_in);
+
+    /******************
+    * Caches the mass delta adds to the ngrams of each length for the vocabularies used by
+    * sentenceProbability and logSentenceProbability, so scoring does not raise them to a power per token.
+    * Setting the delta builds the cache, so only reading more ngrams afterwards calls for building it again
+    * @return 0 success
+    ******************/
+    int buildMasses();
+
+    /******************
+    * Writes the probability of every stored ngram given the tokens before it to an ARPA file
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written or a length is counted in a sketch
+    * @return -2 the document does not hold every length from 1 to its longest length
+    ******************/
+    int saveArpa(std::string fileName_in);
+
+    /******************
+    * Prunes the document as Document::prune does with only the count cutoffs. The model does not back off,
+    * so the relative entropy scores would rate the dropped ngrams by a probability it never gives them
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in);
+
+    /******************
+    * Prunes the document with only the count cutoffs and scores held out sentences as Document::prune does
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in, int length_in,
+      std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in);
+
+    /******************
+    * Packs the counts as Document::packCounts does and stores the probability of every stored ngram
+    * as the code of a bin of its log, with the bins of each length chosen from its probabilities.
+    * Stored ngrams are then scored from their code alone, ngrams that are not stored as before.
+    * The codes hold the probabilities for the vocabulary of each length that advanceState uses, other
+    * vocabularies are scored as before. Changing delta drops the codes
+    * @param  numBits_in number of bits of each code from 1 to QUANTIZED_MAX_BITS, 8 to 16 keeps the error small
+    * @return 0  success
+    * @return -1 the counts could not be packed into a trie
+    ******************/
+    int quantize(int numBits_in);
+
+
     /******************
     * Sets the documents delta value
     * @param delta_in new delta value
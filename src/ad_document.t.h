@@ -11,7 +11,55 @@ namespace nlp {
   //Sets a new delta value
   template <typename Type> int ADDocument<Type>::setDelta(double delta_in) {
     delta = delta_in;
-    return 0;
+    //The cached masses and the codes were found with the old delta, the masses are cheap enough to find again
+    this->quantized.clear();
+    return buildMasses();
+  }
+
+  //Writes the document and its delta value to a model file
+  template <typename Type> int ADDocument<Type>::saveModel(std::string fileName_in) {
+    ModelHeader header;
+    std::vector<std::vector<FrequencyPair>> frequencies;
+    std::vector<std::vector<ProbabilityPair>> probabilities;
+
+    header.kind = MODEL_KIND_AD;
+    header.delta = delta;
+    header.threshold = 0;
+    header.vocabulary = 0;
+
+    return this->writeModel(fileName_in, &header, &frequencies, &probabilities);
+  }
+
+  //Writes the probability of every stored ngram given the tokens before it to an ARPA file
+  template <typename Type> int ADDocument<Type>::saveArpa(std::string fileName_in) {
+    return this->writeArpa(fileName_in, [this](std::vector<Type> * ngram_in) {
+      return ngramProbability(ngram_in);
+    });
+  }
+
+  //Prunes the document with only the count cutoffs
+  template <typename Type> int ADDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in) {
+    //Without backing off a dropped ngram gets only the delta floor, not the probability its score was found with
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, location_in);
+  }
+
+  //Prunes the document with only the count cutoffs and scores held out sentences
+  template <typename Type> int ADDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in,
+    int length_in, std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in) {
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, model_in, length_in, heldOut_in, location_in);
+  }
+
+  //Stores the probability of every stored ngram as the code of a bin of its log
+  template <typename Type> int ADDocument<Type>::quantize(int numBits_in) {
+    return this->quantizeProbabilities(numBits_in, [this](ScorerState * state_in, int length_in) {
+      return nextProbability(state_in, this->numDistinctNgrams(length_in));
+    });
   }
 
   //Computes the prabability of an ngram occuring in the document
@@ -27,26 +75,100 @@ namespace nlp {
     given.pop_back();
 
     numerator = (double) this->countNgram(ngram_in) + delta;
-    denominator = (double) (ngram_in->size() > 1 ? this->countNgram(&given) : this->numNgrams(1)) + delta * pow((double) vocabulary_in, (double) ngram_in->size());
+    denominator = (double) (ngram_in->size() > 1 ? this->countNgram(&given) : this->numNgrams(1)) + deltaMass(vocabulary_in, ngram_in->size());
+
+    return numerator / denominator;
+  }
+
+  //Finds the probability mass delta adds to every ngram of a length
+  template <typename Type> double ADDocument<Type>::deltaMass(int vocabulary_in, int length_in) {
+    int vocabularyIterator;
+
+    for (vocabularyIterator = 0; vocabularyIterator < (int) massVocabularies.size(); ++vocabularyIterator) {
+      if (massVocabularies[vocabularyIterator] == vocabulary_in && length_in <= (int) masses[vocabularyIterator].size()) {
+        return masses[vocabularyIterator][length_in - 1];
+      }
+    }
+
+    return delta * pow((double) vocabulary_in, (double) length_in);
+  }
+
+  //Caches the mass delta adds to the ngrams of each length
+  template <typename Type> int ADDocument<Type>::buildMasses() {
+    int lengthIterator;
+    int powerIterator;
+    int longest;
+
+    massVocabularies.clear();
+    masses.clear();
+    longest = this->ngramLengths.empty() ? 0 : *std::max_element(this->ngramLengths.begin(), this->ngramLengths.end());
+    //Every length read gives the vocabulary that scoring with that length uses
+    for (lengthIterator = 0; lengthIterator < (int) this->ngramLengths.size(); ++lengthIterator) {
+      massVocabularies.push_back(this->numDistinctNgrams(this->ngramLengths[lengthIterator]));
+      masses.push_back(std::vector<double>());
+      for (powerIterator = 1; powerIterator <= longest; ++powerIterator) {
+        masses.back().push_back(delta * pow((double) massVocabularies.back(), (double) powerIterator));
+      }
+    }
+
+    return 0;
+  }
+
+  //Computes the probability of the token stored just after a state's context given the context
+  template <typename Type> double ADDocument<Type>::nextProbability(ScorerState * state_in, int vocabulary_in) {
+    double numerator;
+    double denominator;
+    int length;
+    int fullCount;
+    int givenCount;
+    double logProbability;
+
+    //A token with no context is divided by the number of tokens in the document
+    length = state_in->contextLength + 1;
+    //Stored ngrams of a quantized document are scored from their code when the vocabulary is the one it was found with
+    if (vocabulary_in == this->numDistinctNgrams(length) && this->quantizedProbability(state_in->context, length, &logProbability)) {
+      return exp(logProbability);
+    }
+    fullCount = this->countIdsGiven(state_in->context, length, length - 1, &givenCount);
+    numerator = (double) fullCount + delta;
+    denominator = (double) givenCount + deltaMass(vocabulary_in, length);
 
     return numerator / denominator;
   }
 
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double ADDocument<Type>::advanceState(int length_in, ScorerState * state_in, Type * token_in) {
+    //Tokens never seen keep an identifier no ngram contains
+    return advanceState(length_in, state_in, this->lexicon.findToken(token_in));
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double ADDocument<Type>::advanceState(int length_in, ScorerState * state_in, TokenId id_in) {
+    double result;
+
+    trimState(state_in, length_in);
+    state_in->context[state_in->contextLength] = id_in;
+    result = log(nextProbability(state_in, this->numDistinctNgrams(length_in)));
+    acceptState(state_in, length_in, result);
+
+    return result;
+  }
+
   //Computes the probability of a sentence occuring based
   template <typename Type> double ADDocument<Type>::sentenceProbability(int length_in, std::vector<Type> * sentence_in) {
+    ScorerState state;
     double result;
     int sentenceIterator;
-    std::vector<Type> currentNgram;
 
+    resetState(&state);
     result = 1.0;
     for(sentenceIterator = 0; sentenceIterator < (int) sentence_in->size(); ++sentenceIterator) {
-      //Trim any excess tokens from the current nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      //Add the current token to the back of the current ngram
-      currentNgram.push_back((*sentence_in)[sentenceIterator]);
-      result = result * ngramProbability(&currentNgram);
+      trimState(&state, length_in);
+      state.context[state.contextLength] = this->lexicon.findToken(&(*sentence_in)[sentenceIterator]);
+      //Each ngram uses the number of distinct ngrams of its own length as the vocabulary
+      result = result * nextProbability(&state, this->numDistinctNgrams(state.contextLength + 1));
+      //Only the product is kept so the state's log probability is left alone
+      acceptState(&state, length_in, 0);
     }
 
     return result;
@@ -57,22 +179,18 @@ namespace nlp {
   }
 
   template <typename Type> double ADDocument<Type>::logSentenceProbability(int length_in, std::vector<Type> * sentence_in, int vocabulary_in) {
-    double result;
+    ScorerState state;
     int sentenceIterator;
-    std::vector<Type> currentNgram;
 
-    result = 0.0; 
+    //The context of each token slides along in place rather than being copied
+    resetState(&state);
     for(sentenceIterator = 0; sentenceIterator < (int) sentence_in->size(); ++sentenceIterator) {
-      //Trim any excess tokens from the current nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      //Add the current token to the back of the current ngram
-      currentNgram.push_back((*sentence_in)[sentenceIterator]);
-      result = result + log(ngramProbability(&currentNgram, vocabulary_in));
-    }    
+      trimState(&state, length_in);
+      state.context[state.contextLength] = this->lexicon.findToken(&(*sentence_in)[sentenceIterator]);
+      acceptState(&state, length_in, log(nextProbability(&state, vocabulary_in)));
+    }
 
-    return result;
+    return state.logProbability;
   }
 
   //Creates a new instance of ADDocument finding all the ngrams from size 1 to the specified number
@@ -93,6 +211,42 @@ namespace nlp {
       setDelta(delta_in);
     }
 
+  //Creates a new instance of ADDocument finding all the ngrams on several threads
+  template <typename Type> ADDocument<Type>::ADDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in, double delta_in)
+    :Document<Type>(tokens_in, gramLengths_in, numThreads_in) {
+      setDelta(delta_in);
+    }
+
+  //Creates a new instance of ADDocument from tokens that have already been given identifiers
+  template <typename Type> ADDocument<Type>::ADDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in, double delta_in)
+    :Document<Type>(lexicon_in, tokens_in, gramLengths_in) {
+      setDelta(delta_in);
+    }
+
+  //Creates a new instance of ADDocument by counting ngrams as the tokens are read from a source
+  template <typename Type> ADDocument<Type>::ADDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, double delta_in)
+    :Document<Type>(source_in, gramLengths_in, keepTokens_in) {
+      setDelta(delta_in);
+    }
+
+  //Creates a new instance of ADDocument that counts the longer lengths in count-min sketches
+  template <typename Type> ADDocument<Type>::ADDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, double delta_in)
+    :Document<Type>(tokens_in, gramLengths_in, options_in) {
+      setDelta(delta_in);
+    }
+
+  //Creates a new instance of ADDocument that counts the longer lengths in count-min sketches as the tokens are read from a source
+  template <typename Type> ADDocument<Type>::ADDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, double delta_in)
+    :Document<Type>(source_in, gramLengths_in, options_in) {
+      setDelta(delta_in);
+    }
+
+  //Creates a new instance of ADDocument that queries its counts directly from a mapped model file
+  template <typename Type> ADDocument<Type>::ADDocument(ModelFile * model_in)
+    :Document<Type>(model_in) {
+      setDelta(model_in->getHeader()->delta);
+    }
+
   //Default constructor and destructor
   template <typename Type> ADDocument<Type>::ADDocument() {}
   template <typename Type> ADDocument<Type>::~ADDocument() {}
@@ -0,0 +1,91 @@
+//A table for drawing indexes from a fixed weighted distrubution in constant time using Walker's alias method
+
+#include "alias_table.h"
+
+namespace nlp {
+
+  //Builds the table from the weight of each index
+  int AliasTable::build(const std::vector<double> * weights_in) {
+    std::vector<int> small;
+    std::vector<int> large;
+    double total;
+    int numWeights;
+    int weightIterator;
+    int column;
+    int donor;
+
+    thresholds.clear();
+    aliases.clear();
+    numWeights = (int) weights_in->size();
+    total = 0;
+    for (weightIterator = 0; weightIterator < numWeights; ++weightIterator) {
+      total += (*weights_in)[weightIterator];
+    }
+    if (numWeights == 0 || total <= 0) {
+      return -1;
+    }
+
+    //Each weight is scaled so the average column holds exactly 1
+    thresholds.resize(numWeights);
+    aliases.resize(numWeights);
+    for (weightIterator = 0; weightIterator < numWeights; ++weightIterator) {
+      thresholds[weightIterator] = (*weights_in)[weightIterator] * numWeights / total;
+      aliases[weightIterator] = weightIterator;
+      if (thresholds[weightIterator] < 1) {
+        small.push_back(weightIterator);
+      } else {
+        large.push_back(weightIterator);
+      }
+    }
+
+    //Every column short of 1 is filled up by a column with more than 1, which may then fall short itself
+    while (! small.empty() && ! large.empty()) {
+      column = small.back();
+      small.pop_back();
+      donor = large.back();
+      aliases[column] = donor;
+      thresholds[donor] -= 1 - thresholds[column];
+      if (thresholds[donor] < 1) {
+        large.pop_back();
+        small.push_back(donor);
+      }
+    }
+    //Whatever is left only misses 1 by rounding error
+    for (weightIterator = 0; weightIterator < (int) small.size(); ++weightIterator) {
+      thresholds[small[weightIterator]] = 1;
+    }
+    for (weightIterator = 0; weightIterator < (int) large.size(); ++weightIterator) {
+      thresholds[large[weightIterator]] = 1;
+    }
+
+    return 0;
+  }
+
+  //Draws an index with a chance proportional to its weight
+  int AliasTable::sample(RandomGenerator * generator_in) {
+    double position;
+    int column;
+
+    if (thresholds.empty()) {
+      return -1;
+    }
+
+    //The top 53 bits give a uniform double in [0, 1), its whole part picks the column and the rest decides on the alias
+    position = (double) ((*generator_in)() >> 11) * (1.0 / 9007199254740992.0) * thresholds.size();
+    column = (int) position;
+    if (column >= (int) thresholds.size()) {
+      column = (int) thresholds.size() - 1;
+    }
+
+    return position - column < thresholds[column] ? column : aliases[column];
+  }
+
+  //Finds the number of indexes in the table
+  int AliasTable::size() {
+    return (int) thresholds.size();
+  }
+
+  //Default constructor and destructor
+  AliasTable::AliasTable() {}
+  AliasTable::~AliasTable() {}
+};
@@ -0,0 +1,61 @@
+/**************************************************************
+* A table for drawing indexes from a fixed weighted distrubution
+* in constant time using Walker's alias method
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_ALIAS_TABLE
+#define _H_ALIAS_TABLE
+
+#include <vector> //std::vector
+#include <random> //std::mt19937_64
+
+namespace nlp {
+
+  /* Generator of the random numbers used to draw from alias tables */
+  typedef std::mt19937_64 RandomGenerator;
+
+  class AliasTable {
+  private:
+    /* Chance of keeping each column rather than taking its alias, scaled so a column is drawn uniformly */
+    std::vector<double> thresholds;
+
+    /* Index taken instead of each column when the column is not kept */
+    std::vector<int> aliases;
+
+  public:
+    //Default constructor and destructor
+    AliasTable();
+    ~AliasTable();
+
+    /*******************
+    * Builds the table from the weight of each index, replacing anything stored.
+    * The weights do not need to sum to 1
+    * @param  weights_in weight of each index, none negative
+    * @return 0  success
+    * @return -1 there are no weights or they sum to 0
+    *******************/
+    int build(const std::vector<double> * weights_in);
+
+    /*******************
+    * Draws an index with a chance proportional to its weight
+    * @param  generator_in generator to draw the random number from
+    * @return the drawn index or -1 if the table is empty
+    *******************/
+    int sample(RandomGenerator * generator_in);
+
+    /*******************
+    * Finds the number of indexes in the table
+    * @return number of indexes, 0 if the table was not built
+    *******************/
+    int size();
+  };
+
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**************************************************************
+* A backoff language model read from a file in the ARPA format
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_ARPA_MODEL
+#define _H_ARPA_MODEL
+
+#include <string>    //std::string
+#include <vector>    //std::vector
+#include <thread>    //std::thread
+#include <atomic>    //std::atomic
+#include <cmath>     //pow()   exp()
+#include <cstdio>    //sscanf()
+#include <cstring>   //memchr()   memcmp()   strlen()
+#include <algorithm> //std::min()
+
+#include "lexicon.t.h"
+#include "ngram_table.t.h"
+#include "mapped_file.h"
+#include "model_file.h"
+#include "languageModel.i.h"
+
+#define ARPA_UNKNOWN "<unk>"
+#define ARPA_LN_10 2.30258509299404568402
+
+namespace nlp {
+
+  /* Log10 probability and backoff weight of an ngram in an ARPA file */
+  struct ArpaEntry {
+    float logProbability;
+    float backoff;
+  };
+
+  template <typename Type> class ArpaModel : public LanguageModel<Type> {
+  private:
+    /* A piece of an ngram section that is parsed on its own */
+    struct ArpaChunk {
+      int length;
+      const char * begin;
+      const char * end;
+      std::vector<TokenId> keys;
+      std::vector<ArpaEntry> entries;
+      int status;
+    };
+
+    /* Tokens of the model and their identifiers */
+    Lexicon<Type> lexicon;
+
+    /* Entries of each ngram length, the index is the length minus 1 */
+    std::vector<NgramTable<ArpaEntry>> orders;
+
+    /* Identifier of the unknown token or UNKNOWN_TOKEN_ID if the model has none */
+    TokenId unknownId;
+
+    /*******************
+    * Finds the start of the next line
+    * @param  cursor_in start of the current line
+    * @param  end_in    end of the file
+    * @return start of the next line or end_in if this is the last line
+    *******************/
+    static const char * nextLine(const char * cursor_in, const char * end_in);
+
+    /*******************
+    * Finds the start of the next line beginning with a backslash, which starts a section
+    * @param  cursor_in start of a line to search from
+    * @param  end_in    end of the file
+    * @return start of the section line or end_in if there are none left
+    *******************/
+    static const char * nextSection(const char * cursor_in, const char * end_in);
+
+    /*******************
+    * Reads a decimal number without reading past the end of the line
+    * @param  cursor_in   location of the cursor which is moved past the number
+    * @param  end_in      end of the line
+    * @param  location_in location to store the number
+    * @return 0  success
+    * @return -1 there is no number at the cursor
+    *******************/
+    static int parseNumber(const char ** cursor_in, const char * end_in, float * location_in);
+
+    /*******************
+    * Reads one line of an ngram section. The unigram section adds its tokens to the lexicon
+    * and the other sections only look tokens up so they may be read by many threads at once
+    * @param  begin_in    start of the line
+    * @param  end_in      end of the line
+    * @param  length_in   length of the ngrams in the section
+    * @param  token_in    buffer used to hold each token as it is read
+    * @param  keys_out    location to append the identifiers of the ngram to
+    * @param  entries_out location to append the entry of the ngram to
+    * @return 0  success
+    * @return 1  line is blank
+    * @return -2 line is malformed or uses a token missing from the unigrams
+    *******************/
+    int parseLine(const char * begin_in, const char * end_in, int length_in, Type * token_in, std::vector<TokenId> * keys_out, std::vector<ArpaEntry> * entries_out);
+
+    /*******************
+    * Reads every line of a chunk of an ngram section into the chunk
+    * @param  chunk_in chunk to read
+    * @return 0 success
+    *******************/
+    int parseChunk(ArpaChunk * chunk_in);
+
+    /*******************
+    * Computes the log10 probability of the last identifier given the ones before it,
+    * backing off to shorter contexts until the ngram is found
+    * @param  ngram_in  identifiers of the ngram
+    * @param  length_in number of identifiers in the ngram
+    * @return log10 probability of the last token
+    *******************/
+    double logProbability(const TokenId * ngram_in, int length_in);
+
+    /*******************
+    * Finds the identifiers of tokens, using the unknown token for any the model has not seen
+    * @param  tokens_in   tokens to find
+    * @param  location_in location to store the identifiers
+    * @return 0 success
+    *******************/
+    int findIds(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in);
+
+  public:
+    //Default constructor and destructor
+    ArpaModel();
+    ~ArpaModel();
+
+    /*******************
+    * Loads a model from an ARPA file, replacing any model already loaded. The unigrams are
+    * read first to build the lexicon and the longer ngram sections are then split into
+    * chunks that are read in parallel
+    * @param  fileName_in   name of the ARPA file
+    * @param  numThreads_in number of threads used to read the longer ngram sections
+    * @return 0  success
+    * @return -1 file could not be opened
+    * @return -2 file is not a valid ARPA file
+    *******************/
+    int load(std::string fileName_in, int numThreads_in);
+
+    /*******************
+    * Finds the length of the longest ngrams in the model
+    * @return longest ngram length
+    *******************/
+    int getOrder();
+
+    /*******************
+    * Finds the lexicon holding the tokens of the model
+    * @return the models lexicon
+    *******************/
+    Lexicon<Type> * getLexicon();
+
+    /******************
+    * Computes the probability of the last token of an ngram given the tokens before it
+    * @param  ngram_in  ngram to check probability of
+    * @return probability of the last token of the ngram
+    ******************/
+    double ngramProbability(std::vector<Type> * ngram_in);
+
+    /******************
+    * Computes the probability of a sentence occuring based on the backoff language model
+    * @param  length_in   length of ngrams to check
+    * @param  sentence_in sentence to find the probability of
+    * @return prabability of sentence occurance
+    ******************/
+    double sentenceProbability(int length_in, std::vector<Type> * sentence_in);
+
+    /******************
+    * Computes the natural log of the probability of a sentence based on the backoff language model
+    * @param  length_in   length of ngrams to check
+    * @param  sentence_in sentence to find the probability of
+    * @return log prabability of sentence occurance
+    ******************/
+    double logSentenceProbability(int length_in, std::vector<Type> * sentence_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  token_in  token to score
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, Type * token_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  id_in     identifier of the token to score in the lexicon of the model
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, TokenId id_in);
+  };
+
+};
+
+#endif
@@ -0,0 +1,454 @@
+//A backoff language model read from a file in the ARPA format
+
+#ifndef _T_ARPA_MODEL
+#define _T_ARPA_MODEL
+
+#include "arpa_model.h"
+
+namespace nlp {
+
+  //Finds the start of the next line
+  template <typename Type> const char * ArpaModel<Type>::nextLine(const char * cursor_in, const char * end_in) {
+    const char * newline;
+
+    newline = (const char *) memchr(cursor_in, '\n', end_in - cursor_in);
+    return newline == NULL ? end_in : newline + 1;
+  }
+
+  //Finds the start of the next line beginning with a backslash
+  template <typename Type> const char * ArpaModel<Type>::nextSection(const char * cursor_in, const char * end_in) {
+    const char * slash;
+
+    while (cursor_in < end_in) {
+      if (*cursor_in == '\\') {
+        return cursor_in;
+      }
+      //Only backslashes at the start of a line begin a section
+      slash = (const char *) memchr(cursor_in, '\\', end_in - cursor_in);
+      if (slash == NULL) {
+        return end_in;
+      }
+      if (slash[-1] == '\n') {
+        return slash;
+      }
+      cursor_in = nextLine(slash, end_in);
+    }
+
+    return end_in;
+  }
+
+  //Reads a decimal number without reading past the end of the line
+  template <typename Type> int ArpaModel<Type>::parseNumber(const char ** cursor_in, const char * end_in, float * location_in) {
+    const char * cursor;
+    double mantissa;
+    int exponent;
+    int exponentSign;
+    int numDigits;
+    int negative;
+
+    cursor = *cursor_in;
+    mantissa = 0;
+    exponent = 0;
+    numDigits = 0;
+    negative = 0;
+
+    if (cursor < end_in && (*cursor == '-' || *cursor == '+')) {
+      negative = *cursor == '-';
+      ++cursor;
+    }
+    while (cursor < end_in && *cursor >= '0' && *cursor <= '9') {
+      mantissa = mantissa * 10 + (*cursor - '0');
+      ++numDigits;
+      ++cursor;
+    }
+    if (cursor < end_in && *cursor == '.') {
+      ++cursor;
+      while (cursor < end_in && *cursor >= '0' && *cursor <= '9') {
+        mantissa = mantissa * 10 + (*cursor - '0');
+        --exponent;
+        ++numDigits;
+        ++cursor;
+      }
+    }
+    if (numDigits == 0) {
+      return -1;
+    }
+    if (cursor < end_in && (*cursor == 'e' || *cursor == 'E')) {
+      ++cursor;
+      exponentSign = 1;
+      if (cursor < end_in && (*cursor == '-' || *cursor == '+')) {
+        exponentSign = *cursor == '-' ? -1 : 1;
+        ++cursor;
+      }
+      numDigits = 0;
+      while (cursor < end_in && *cursor >= '0' && *cursor <= '9') {
+        numDigits = numDigits * 10 + (*cursor - '0');
+        ++cursor;
+      }
+      exponent += exponentSign * numDigits;
+    }
+
+    *location_in = (float) ((negative ? -mantissa : mantissa) * (exponent == 0 ? 1 : pow(10.0, exponent)));
+    *cursor_in = cursor;
+    return 0;
+  }
+
+  //Reads one line of an ngram section
+  template <typename Type> int ArpaModel<Type>::parseLine(const char * begin_in, const char * end_in, int length_in, Type * token_in, std::vector<TokenId> * keys_out, std::vector<ArpaEntry> * entries_out) {
+    const char * cursor;
+    const char * tokenStart;
+    ArpaEntry entry;
+    TokenId id;
+    int tokenIterator;
+
+    //Fields may be split by tabs or spaces and lines may end in a carriage return
+    cursor = begin_in;
+    while (cursor < end_in && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+      ++cursor;
+    }
+    if (cursor == end_in) {
+      return 1;
+    }
+
+    if (parseNumber(&cursor, end_in, &entry.logProbability)) {
+      return -2;
+    }
+
+    for (tokenIterator = 0; tokenIterator < length_in; ++tokenIterator) {
+      while (cursor < end_in && (*cursor == ' ' || *cursor == '\t')) {
+        ++cursor;
+      }
+      tokenStart = cursor;
+      while (cursor < end_in && *cursor != ' ' && *cursor != '\t' && *cursor != '\r') {
+        ++cursor;
+      }
+      if (cursor == tokenStart) {
+        return -2;
+      }
+      bytesToToken(tokenStart, (int) (cursor - tokenStart), token_in);
+      //Every token has to be given its identifier by the unigram section
+      id = length_in == 1 ? lexicon.addToken(token_in) : lexicon.findToken(token_in);
+      if (id == UNKNOWN_TOKEN_ID) {
+        return -2;
+      }
+      keys_out->push_back(id);
+    }
+
+    //The backoff weight is optional and is 0 when it is missing
+    entry.backoff = 0;
+    while (cursor < end_in && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+      ++cursor;
+    }
+    if (cursor < end_in && parseNumber(&cursor, end_in, &entry.backoff)) {
+      return -2;
+    }
+    while (cursor < end_in && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+      ++cursor;
+    }
+    if (cursor != end_in) {
+      return -2;
+    }
+
+    entries_out->push_back(entry);
+    return 0;
+  }
+
+  //Reads every line of a chunk of an ngram section into the chunk
+  template <typename Type> int ArpaModel<Type>::parseChunk(ArpaChunk * chunk_in) {
+    const char * cursor;
+    const char * lineEnd;
+    Type token;
+
+    cursor = chunk_in->begin;
+    while (cursor < chunk_in->end) {
+      lineEnd = nextLine(cursor, chunk_in->end);
+      chunk_in->status = parseLine(cursor, lineEnd[-1] == '\n' ? lineEnd - 1 : lineEnd, chunk_in->length, &token, &chunk_in->keys, &chunk_in->entries);
+      if (chunk_in->status < 0) {
+        return 0;
+      }
+      cursor = lineEnd;
+    }
+    chunk_in->status = 0;
+
+    return 0;
+  }
+
+  //Loads a model from an ARPA file
+  template <typename Type> int ArpaModel<Type>::load(std::string fileName_in, int numThreads_in) {
+    MappedFile file;
+    std::vector<int> counts;
+    std::vector<const char *> sectionStarts;
+    std::vector<const char *> sectionEnds;
+    std::vector<ArpaChunk> chunks;
+    std::vector<std::thread> threads;
+    std::atomic<int> nextChunk;
+    std::string unknownBytes;
+    Type unknown;
+    const char * data;
+    const char * end;
+    const char * cursor;
+    const char * chunkEnd;
+    int lengthIterator;
+    int chunkIterator;
+    int threadIterator;
+    int numChunks;
+    int length;
+    int count;
+    int result;
+
+    if (file.open(fileName_in, 1)) {
+      return -1;
+    }
+    data = file.getData();
+    end = data + file.getSize();
+
+    lexicon = Lexicon<Type>();
+    orders.clear();
+    unknownId = UNKNOWN_TOKEN_ID;
+    numThreads_in = numThreads_in < 1 ? 1 : numThreads_in;
+
+    //The header lists the number of ngrams of each length
+    cursor = nextSection(data, end);
+    if (end - cursor < 6 || memcmp(cursor, "\\data\\", 6) != 0) {
+      return -2;
+    }
+    cursor = nextLine(cursor, end);
+    while (cursor < end && *cursor != '\\') {
+      if (sscanf(std::string(cursor, nextLine(cursor, end) - cursor).c_str(), "ngram %d=%d", &length, &count) == 2) {
+        if (length != (int) counts.size() + 1 || count < 0) {
+          return -2;
+        }
+        counts.push_back(count);
+      }
+      cursor = nextLine(cursor, end);
+    }
+    if (counts.empty()) {
+      return -2;
+    }
+
+    //Find where each section starts, they must be in order and followed by the end marker
+    for (lengthIterator = 1; lengthIterator <= (int) counts.size(); ++lengthIterator) {
+      std::string title = "\\" + std::to_string(lengthIterator) + "-grams:";
+      if ((size_t) (end - cursor) < title.size() || memcmp(cursor, title.data(), title.size()) != 0) {
+        return -2;
+      }
+      cursor = nextLine(cursor, end);
+      sectionStarts.push_back(cursor);
+      cursor = nextSection(cursor, end);
+      sectionEnds.push_back(cursor);
+    }
+    if (end - cursor < 5 || memcmp(cursor, "\\end\\", 5) != 0) {
+      return -2;
+    }
+
+    for (lengthIterator = 1; lengthIterator <= (int) counts.size(); ++lengthIterator) {
+      orders.push_back(NgramTable<ArpaEntry>(lengthIterator));
+      orders.back().reserve(counts[lengthIterator - 1]);
+    }
+
+    //The unigrams build the lexicon so they are read on their own
+    chunks.resize(1);
+    chunks[0].length = 1;
+    chunks[0].begin = sectionStarts[0];
+    chunks[0].end = sectionEnds[0];
+    parseChunk(&chunks[0]);
+    if (chunks[0].status < 0) {
+      return -2;
+    }
+
+    //Every longer section is split on line boundaries into a chunk for each thread
+    for (lengthIterator = 2; lengthIterator <= (int) counts.size(); ++lengthIterator) {
+      cursor = sectionStarts[lengthIterator - 1];
+      for (chunkIterator = 0; chunkIterator < numThreads_in && cursor < sectionEnds[lengthIterator - 1]; ++chunkIterator) {
+        chunkEnd = cursor + (sectionEnds[lengthIterator - 1] - cursor) / (numThreads_in - chunkIterator);
+        chunkEnd = chunkIterator == numThreads_in - 1 ? sectionEnds[lengthIterator - 1] : nextLine(chunkEnd, sectionEnds[lengthIterator - 1]);
+        chunks.push_back(ArpaChunk());
+        chunks.back().length = lengthIterator;
+        chunks.back().begin = cursor;
+        chunks.back().end = chunkEnd;
+        cursor = chunkEnd;
+      }
+    }
+
+    //Threads take the next chunk that has not been read until there are none left
+    numChunks = (int) chunks.size();
+    nextChunk = 1;
+    for (threadIterator = 0; threadIterator < numThreads_in && threadIterator < numChunks - 1; ++threadIterator) {
+      threads.push_back(std::thread([this, &chunks, &nextChunk, numChunks]() {
+        int chunk;
+        while ((chunk = nextChunk++) < numChunks) {
+          parseChunk(&chunks[chunk]);
+        }
+      }));
+    }
+    for (threadIterator = 0; threadIterator < (int) threads.size(); ++threadIterator) {
+      threads[threadIterator].join();
+    }
+
+    //Each length is filled on its own thread since the lengths share no tables
+    threads.clear();
+    for (lengthIterator = 1; lengthIterator <= (int) counts.size(); ++lengthIterator) {
+      threads.push_back(std::thread([this, &chunks, lengthIterator]() {
+        NgramTable<ArpaEntry> & table = orders[lengthIterator - 1];
+        size_t entryIterator;
+        for (auto & chunk : chunks) {
+          if (chunk.length != lengthIterator) {
+            continue;
+          }
+          for (entryIterator = 0; entryIterator < chunk.entries.size(); ++entryIterator) {
+            *table.insert(chunk.keys.data() + entryIterator * lengthIterator) = chunk.entries[entryIterator];
+          }
+          //Release the chunk as soon as it has been stored
+          chunk.keys = std::vector<TokenId>();
+          chunk.entries = std::vector<ArpaEntry>();
+        }
+      }));
+    }
+    for (threadIterator = 0; threadIterator < (int) threads.size(); ++threadIterator) {
+      threads[threadIterator].join();
+    }
+
+    //A section holding a different number of ngrams than the header says is malformed
+    result = 0;
+    for (lengthIterator = 1; lengthIterator <= (int) counts.size(); ++lengthIterator) {
+      if (orders[lengthIterator - 1].size() != counts[lengthIterator - 1]) {
+        result = -2;
+      }
+    }
+    for (chunkIterator = 0; chunkIterator < numChunks; ++chunkIterator) {
+      if (chunks[chunkIterator].status < 0) {
+        result = -2;
+      }
+    }
+    if (result) {
+      orders.clear();
+      return result;
+    }
+
+    //Tokens the model has never seen are scored as the unknown token if it has one
+    bytesToToken(ARPA_UNKNOWN, (int) strlen(ARPA_UNKNOWN), &unknown);
+    tokenToBytes(&unknown, &unknownBytes);
+    if (unknownBytes == ARPA_UNKNOWN) {
+      unknownId = lexicon.findToken(&unknown);
+    }
+
+    return 0;
+  }
+
+  //Computes the log10 probability of the last identifier given the ones before it
+  template <typename Type> double ArpaModel<Type>::logProbability(const TokenId * ngram_in, int length_in) {
+    const ArpaEntry * entry;
+    double backoff;
+    int start;
+
+    //Contexts longer than the model are cut down to the longest length it holds
+    start = length_in > (int) orders.size() ? length_in - (int) orders.size() : 0;
+    backoff = 0;
+    for (; start < length_in; ++start) {
+      entry = orders[length_in - start - 1].find(ngram_in + start);
+      if (entry != NULL) {
+        return backoff + entry->logProbability;
+      }
+      //A missing ngram backs off with the weight of its context
+      if (length_in - start > 1) {
+        entry = orders[length_in - start - 2].find(ngram_in + start);
+        if (entry != NULL) {
+          backoff += entry->backoff;
+        }
+      }
+    }
+
+    return ARPA_LOG_ZERO;
+  }
+
+  //Finds the identifiers of tokens, using the unknown token for any the model has not seen
+  template <typename Type> int ArpaModel<Type>::findIds(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in) {
+    TokenId id;
+    int tokenIterator;
+
+    location_in->clear();
+    location_in->reserve(tokens_in->size());
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      id = lexicon.findToken(&(*tokens_in)[tokenIterator]);
+      location_in->push_back(id == UNKNOWN_TOKEN_ID ? unknownId : id);
+    }
+
+    return 0;
+  }
+
+  //Finds the length of the longest ngrams in the model
+  template <typename Type> int ArpaModel<Type>::getOrder() {
+    return (int) orders.size();
+  }
+
+  //Finds the lexicon holding the tokens of the model
+  template <typename Type> Lexicon<Type> * ArpaModel<Type>::getLexicon() {
+    return &lexicon;
+  }
+
+  //Computes the probability of the last token of an ngram given the tokens before it
+  template <typename Type> double ArpaModel<Type>::ngramProbability(std::vector<Type> * ngram_in) {
+    std::vector<TokenId> ids;
+
+    if (orders.empty() || ngram_in->empty()) {
+      return 0;
+    }
+    findIds(ngram_in, &ids);
+
+    return pow(10.0, logProbability(ids.data(), (int) ids.size()));
+  }
+
+  //Computes the probability of a sentence occuring based on the backoff language model
+  template <typename Type> double ArpaModel<Type>::sentenceProbability(int length_in, std::vector<Type> * sentence_in) {
+    return exp(logSentenceProbability(length_in, sentence_in));
+  }
+
+  //Computes the natural log of the probability of a sentence based on the backoff language model
+  template <typename Type> double ArpaModel<Type>::logSentenceProbability(int length_in, std::vector<Type> * sentence_in) {
+    std::vector<TokenId> ids;
+    int tokenIterator;
+    int contextLength;
+    double result;
+
+    if (orders.empty()) {
+      return ARPA_LOG_ZERO * ARPA_LN_10;
+    }
+    findIds(sentence_in, &ids);
+
+    //Each token is scored given at most the length minus 1 tokens before it
+    result = 0;
+    for (tokenIterator = 0; tokenIterator < (int) ids.size(); ++tokenIterator) {
+      contextLength = std::min(tokenIterator, length_in - 1);
+      result += logProbability(ids.data() + tokenIterator - contextLength, contextLength + 1);
+    }
+
+    return result * ARPA_LN_10;
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double ArpaModel<Type>::advanceState(int length_in, ScorerState * state_in, Type * token_in) {
+    TokenId id;
+
+    id = lexicon.findToken(token_in);
+    return advanceState(length_in, state_in, id == UNKNOWN_TOKEN_ID ? unknownId : id);
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double ArpaModel<Type>::advanceState(int length_in, ScorerState * state_in, TokenId id_in) {
+    double result;
+
+    trimState(state_in, length_in);
+    state_in->context[state_in->contextLength] = id_in;
+    result = (orders.empty() ? ARPA_LOG_ZERO : logProbability(state_in->context, state_in->contextLength + 1)) * ARPA_LN_10;
+    acceptState(state_in, length_in, result);
+
+    return result;
+  }
+
+  //Default constructor and destructor
+  template <typename Type> ArpaModel<Type>::ArpaModel()
+    :unknownId(UNKNOWN_TOKEN_ID) {}
+  template <typename Type> ArpaModel<Type>::~ArpaModel() {}
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**************************************************************
+* Scores many sentences with a language model at once,
+* splitting the sentences between multiple threads
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_BATCH_SCORER
+#define _H_BATCH_SCORER
+
+#include <vector>    //std::vector
+#include <thread>    //std::thread
+#include <atomic>    //std::atomic
+#include <algorithm> //std::min()
+
+#include "languageModel.i.h"
+
+#define BATCH_SCORER_BLOCK_LENGTH 64
+
+namespace nlp {
+
+  template <typename Type> class BatchScorer {
+  private:
+    /* Model every sentence is scored with, it must be safe to query from many threads at once */
+    LanguageModel<Type> * model;
+
+    /* Length of ngrams used to score each sentence */
+    int length;
+
+    /* Number of threads the sentences are split between */
+    int numThreads;
+
+    /*******************
+    * Scores sentences until none are left. Threads take blocks of sentences from a shared
+    * counter so a thread given short sentences does not sit idle while others finish
+    * @param  starts_in    index of the first token of each sentence, with one more entry for the end
+    * @param  tokens_in    tokens of every sentence one after another, NULL if sentences_in is used
+    * @param  sentences_in sentences to score, NULL if tokens_in is used
+    * @param  next_in      index of the next block of sentences to score
+    * @param  location_in  location to store the log probability of each sentence
+    * @return 0 success
+    *******************/
+    int scoreBlocks(std::vector<int> * starts_in, std::vector<Type> * tokens_in, std::vector<std::vector<Type>> * sentences_in,
+      std::atomic<int> * next_in, std::vector<double> * location_in);
+
+    /*******************
+    * Runs scoreBlocks on each thread and waits for them to finish
+    * @param  starts_in    index of the first token of each sentence, with one more entry for the end
+    * @param  tokens_in    tokens of every sentence one after another, NULL if sentences_in is used
+    * @param  sentences_in sentences to score, NULL if tokens_in is used
+    * @param  location_in  location to store the log probability of each sentence
+    * @return 0 success
+    *******************/
+    int scoreAll(std::vector<int> * starts_in, std::vector<Type> * tokens_in, std::vector<std::vector<Type>> * sentences_in,
+      std::vector<double> * location_in);
+
+  public:
+    /*******************
+    * Creates a new instance of BatchScorer
+    * @param model_in      model to score sentences with, it must be safe to query from many threads at once
+    * @param length_in     length of ngrams used to score each sentence
+    * @param numThreads_in number of threads to split the sentences between
+    *******************/
+    BatchScorer(LanguageModel<Type> * model_in, int length_in, int numThreads_in);
+
+    //Default constructor and destructor
+    BatchScorer();
+    ~BatchScorer();
+
+    /*******************
+    * Finds the natural log of the probability of each of a list of sentences. Empty sentences have a log probability of 0
+    * @param  sentences_in sentences to score
+    * @param  location_in  location to store the log probability of each sentence, in the same order
+    * @return 0 success
+    *******************/
+    int logSentenceProbabilities(std::vector<std::vector<Type>> * sentences_in, std::vector<double> * location_in);
+
+    /*******************
+    * Splits a list of tokens into sentences that each end with an end of sentence token, and finds
+    * the natural log of the probability of each. Tokens after the last end of sentence form one more sentence
+    * @param  tokens_in   tokens to split and score
+    * @param  eos_in      token that ends each sentence
+    * @param  location_in location to store the log probability of each sentence, in the order they appear
+    * @return 0 success
+    *******************/
+    int logSentenceProbabilities(std::vector<Type> * tokens_in, Type * eos_in, std::vector<double> * location_in);
+  };
+
+};
+
+#endif
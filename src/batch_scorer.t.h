@@ -0,0 +1,97 @@
+//Scores many sentences with a language model at once, splitting the sentences between multiple threads
+
+#ifndef _T_BATCH_SCORER
+#define _T_BATCH_SCORER
+
+#include "batch_scorer.h"
+
+namespace nlp {
+
+  //Scores blocks of sentences until none are left
+  template <typename Type> int BatchScorer<Type>::scoreBlocks(std::vector<int> * starts_in, std::vector<Type> * tokens_in,
+    std::vector<std::vector<Type>> * sentences_in, std::atomic<int> * next_in, std::vector<double> * location_in) {
+    std::vector<Type> sentence;
+    std::vector<Type> * current;
+    int numSentences;
+    int blockStart;
+    int sentenceIterator;
+
+    numSentences = location_in->size();
+    while ((blockStart = (*next_in)++ * BATCH_SCORER_BLOCK_LENGTH) < numSentences) {
+      for (sentenceIterator = blockStart; sentenceIterator < std::min(blockStart + BATCH_SCORER_BLOCK_LENGTH, numSentences); ++sentenceIterator) {
+        //Sentences of a token list are copied into the same buffer rather than a new vector each
+        if (sentences_in == NULL) {
+          sentence.assign(tokens_in->begin() + (*starts_in)[sentenceIterator], tokens_in->begin() + (*starts_in)[sentenceIterator + 1]);
+          current = &sentence;
+        } else {
+          current = &(*sentences_in)[sentenceIterator];
+        }
+        //Each thread writes only its own sentences so no locking is needed
+        (*location_in)[sentenceIterator] = current->empty() ? 0 : model->logSentenceProbability(length, current);
+      }
+    }
+
+    return 0;
+  }
+
+  //Runs scoreBlocks on each thread and waits for them to finish
+  template <typename Type> int BatchScorer<Type>::scoreAll(std::vector<int> * starts_in, std::vector<Type> * tokens_in,
+    std::vector<std::vector<Type>> * sentences_in, std::vector<double> * location_in) {
+    std::vector<std::thread> threads;
+    std::atomic<int> next;
+    int numBlocks;
+    int threadIterator;
+
+    next = 0;
+    numBlocks = (location_in->size() + BATCH_SCORER_BLOCK_LENGTH - 1) / BATCH_SCORER_BLOCK_LENGTH;
+    //A single block is scored on the calling thread
+    if (numThreads == 1 || numBlocks <= 1) {
+      return scoreBlocks(starts_in, tokens_in, sentences_in, &next, location_in);
+    }
+    for (threadIterator = 0; threadIterator < std::min(numThreads, numBlocks); ++threadIterator) {
+      threads.push_back(std::thread(&BatchScorer<Type>::scoreBlocks, this, starts_in, tokens_in, sentences_in, &next, location_in));
+    }
+    for (threadIterator = 0; threadIterator < (int) threads.size(); ++threadIterator) {
+      threads[threadIterator].join();
+    }
+
+    return 0;
+  }
+
+  //Finds the natural log of the probability of each of a list of sentences
+  template <typename Type> int BatchScorer<Type>::logSentenceProbabilities(std::vector<std::vector<Type>> * sentences_in, std::vector<double> * location_in) {
+    location_in->assign(sentences_in->size(), 0);
+    return scoreAll(NULL, NULL, sentences_in, location_in);
+  }
+
+  //Splits a list of tokens into sentences and finds the natural log of the probability of each
+  template <typename Type> int BatchScorer<Type>::logSentenceProbabilities(std::vector<Type> * tokens_in, Type * eos_in, std::vector<double> * location_in) {
+    std::vector<int> starts;
+    int tokenIterator;
+
+    //Each sentence keeps the end of sentence token that closes it
+    starts.push_back(0);
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      if ((*tokens_in)[tokenIterator] == *eos_in) {
+        starts.push_back(tokenIterator + 1);
+      }
+    }
+    if (starts.back() != (int) tokens_in->size()) {
+      starts.push_back(tokens_in->size());
+    }
+
+    location_in->assign(starts.size() - 1, 0);
+    return scoreAll(&starts, tokens_in, NULL, location_in);
+  }
+
+  //Creates a new instance of BatchScorer
+  template <typename Type> BatchScorer<Type>::BatchScorer(LanguageModel<Type> * model_in, int length_in, int numThreads_in)
+    :model(model_in), length(length_in), numThreads(numThreads_in < 1 ? 1 : numThreads_in) {}
+
+  //Default constructor and destructor
+  template <typename Type> BatchScorer<Type>::BatchScorer()
+    :model(NULL), length(0), numThreads(1) {}
+  template <typename Type> BatchScorer<Type>::~BatchScorer() {}
+};
+
+#endif
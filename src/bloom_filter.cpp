@@ -0,0 +1,159 @@
+//A blocked bloom filter of ngram hash codes that rules out most ngrams that were never stored before a table is probed
+
+#include <cmath>     //log()   exp()   pow()
+#include <algorithm> //std::copy()
+
+#include "bloom_filter.h"
+
+namespace nlp {
+
+  /* Odd constants that spread one half of a hash code over a different bit of each word of a block */
+  static const unsigned int bloomSalts[BLOOM_BLOCK_WORDS] = {
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+  };
+
+  //Finds the first word of the block a hash code belongs to
+  unsigned int * BloomFilter::findBlock(unsigned long long hash_in) {
+    //The upper half of the hash picks the block without a division
+    return &words[offset + (size_t) (((hash_in >> 32) * (unsigned long long) numBlocks) >> 32) * BLOOM_BLOCK_WORDS];
+  }
+
+  //Copies the blocks and counters of another filter
+  int BloomFilter::copy(const BloomFilter & filter_in) {
+    size_t address;
+
+    numBlocks = filter_in.numBlocks;
+    numKeys = filter_in.numKeys;
+    numProbes = filter_in.numProbes.load(std::memory_order_relaxed);
+    numRejected = filter_in.numRejected.load(std::memory_order_relaxed);
+    numFalsePositives = filter_in.numFalsePositives.load(std::memory_order_relaxed);
+    words.assign(numBlocks * BLOOM_BLOCK_WORDS + BLOOM_LINE_BYTES / sizeof(unsigned int), 0);
+
+    //The new storage is at a different address so the first cache line in it is found again
+    address = (size_t) words.data();
+    offset = ((BLOOM_LINE_BYTES - address % BLOOM_LINE_BYTES) % BLOOM_LINE_BYTES) / sizeof(unsigned int);
+    std::copy(filter_in.words.begin() + filter_in.offset, filter_in.words.begin() + filter_in.offset + numBlocks * BLOOM_BLOCK_WORDS, words.begin() + offset);
+
+    return 0;
+  }
+
+  //Finds the number of bytes a filter needs to hold a number of keys at a false positive rate
+  size_t BloomFilter::bytesNeeded(size_t numKeys_in, double falsePositiveRate_in) {
+    double numBits;
+
+    if (falsePositiveRate_in <= 0 || falsePositiveRate_in >= 1) {
+      falsePositiveRate_in = falsePositiveRate_in <= 0 ? 1e-9 : 0.5;
+    }
+    //Every key sets one bit in each word of its block
+    numBits = -BLOOM_BLOCK_WORDS * (double) numKeys_in / log(1 - pow(falsePositiveRate_in, 1.0 / BLOOM_BLOCK_WORDS));
+
+    return ((size_t) (numBits / 8) / (BLOOM_BLOCK_WORDS * sizeof(unsigned int)) + 1) * BLOOM_BLOCK_WORDS * sizeof(unsigned int);
+  }
+
+  //Empties the filter and sizes it
+  int BloomFilter::reset(size_t numBytes_in) {
+    size_t address;
+
+    numBlocks = (numBytes_in + BLOOM_BLOCK_WORDS * sizeof(unsigned int) - 1) / (BLOOM_BLOCK_WORDS * sizeof(unsigned int));
+    numKeys = 0;
+    numProbes = 0;
+    numRejected = 0;
+    numFalsePositives = 0;
+    words.assign(numBlocks * BLOOM_BLOCK_WORDS + BLOOM_LINE_BYTES / sizeof(unsigned int), 0);
+
+    //Blocks start on a cache line so checking a key reads a single line
+    address = (size_t) words.data();
+    offset = ((BLOOM_LINE_BYTES - address % BLOOM_LINE_BYTES) % BLOOM_LINE_BYTES) / sizeof(unsigned int);
+
+    return 0;
+  }
+
+  //Adds the hash code of a key to the filter
+  int BloomFilter::add(unsigned long long hash_in) {
+    unsigned int * block;
+    unsigned int key;
+    int wordIterator;
+
+    if (numBlocks == 0) {
+      return 0;
+    }
+    block = findBlock(hash_in);
+    key = (unsigned int) hash_in;
+    for (wordIterator = 0; wordIterator < BLOOM_BLOCK_WORDS; ++wordIterator) {
+      block[wordIterator] |= 1u << ((key * bloomSalts[wordIterator]) >> 27);
+    }
+    ++numKeys;
+
+    return 0;
+  }
+
+  //Checks if the hash code of a key may have been added
+  int BloomFilter::contains(unsigned long long hash_in) {
+    unsigned int * block;
+    unsigned int key;
+    unsigned int missing;
+    int wordIterator;
+
+    if (numBlocks == 0) {
+      return 1;
+    }
+    block = findBlock(hash_in);
+    key = (unsigned int) hash_in;
+    //Every word is checked without branching so the loop is done a whole block at a time by the compiler
+    missing = 0;
+    for (wordIterator = 0; wordIterator < BLOOM_BLOCK_WORDS; ++wordIterator) {
+      missing |= ~block[wordIterator] & (1u << ((key * bloomSalts[wordIterator]) >> 27));
+    }
+
+    numProbes.fetch_add(1, std::memory_order_relaxed);
+    if (missing != 0) {
+      numRejected.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+
+    return 1;
+  }
+
+  //Counts a key the filter passed that turned out not to be stored
+  int BloomFilter::recordFalsePositive() {
+    numFalsePositives.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+  }
+
+  //Finds the counters and size of the filter
+  int BloomFilter::getStats(BloomStats * location_in) {
+    double keysPerBlock;
+    double bitRate;
+
+    location_in->numProbes = numProbes.load(std::memory_order_relaxed);
+    location_in->numRejected = numRejected.load(std::memory_order_relaxed);
+    location_in->numFalsePositives = numFalsePositives.load(std::memory_order_relaxed);
+    location_in->numBytes = numBlocks * BLOOM_BLOCK_WORDS * sizeof(unsigned int);
+    //A key is passed when the bit it needs in each of the 32 bit words is set
+    keysPerBlock = numBlocks == 0 ? 0 : (double) numKeys / numBlocks;
+    bitRate = 1 - exp(-keysPerBlock / 32);
+    location_in->expectedRate = numBlocks == 0 ? 1 : pow(bitRate, BLOOM_BLOCK_WORDS);
+
+    return 0;
+  }
+
+  //Finds the number of blocks in the filter
+  size_t BloomFilter::size() {
+    return numBlocks;
+  }
+
+  //Default constructor and destructor
+  BloomFilter::BloomFilter() :offset(0), numBlocks(0), numKeys(0), numProbes(0), numRejected(0), numFalsePositives(0) {}
+  BloomFilter::~BloomFilter() {}
+
+  //Copy constructor and assignment
+  BloomFilter::BloomFilter(const BloomFilter & filter_in) :offset(0), numBlocks(0), numKeys(0), numProbes(0), numRejected(0), numFalsePositives(0) {
+    copy(filter_in);
+  }
+  BloomFilter & BloomFilter::operator=(const BloomFilter & filter_in) {
+    if (this != &filter_in) {
+      copy(filter_in);
+    }
+    return *this;
+  }
+};
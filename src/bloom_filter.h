@@ -0,0 +1,136 @@
+/**************************************************************
+* A blocked bloom filter of ngram hash codes that rules out
+* most ngrams that were never stored before a table is probed
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_BLOOM_FILTER
+#define _H_BLOOM_FILTER
+
+#include <vector>  //std::vector
+#include <atomic>  //std::atomic
+#include <cstddef> //size_t
+
+#define BLOOM_BLOCK_WORDS 8
+#define BLOOM_LINE_BYTES 64
+
+namespace nlp {
+
+  /* Counters and size of a bloom filter */
+  struct BloomStats {
+    /* Number of ngrams checked against the filter */
+    unsigned long long numProbes;
+
+    /* Number of ngrams the filter ruled out without probing the table */
+    unsigned long long numRejected;
+
+    /* Number of ngrams the filter passed that the table did not hold */
+    unsigned long long numFalsePositives;
+
+    /* Number of bytes used by the filter's blocks */
+    size_t numBytes;
+
+    /* False positive rate expected from the number of keys and the size of the filter */
+    double expectedRate;
+  };
+
+  class BloomFilter {
+  private:
+    /* Storage of the blocks, with room to start the first block on a cache line */
+    std::vector<unsigned int> words;
+
+    /* Index in words of the first word of the first block */
+    size_t offset;
+
+    /* Number of blocks of BLOOM_BLOCK_WORDS words, each holding one bit of every key in it per word */
+    size_t numBlocks;
+
+    /* Number of keys added to the filter */
+    size_t numKeys;
+
+    /* Counters updated by every thread that checks the filter */
+    std::atomic<unsigned long long> numProbes;
+    std::atomic<unsigned long long> numRejected;
+    std::atomic<unsigned long long> numFalsePositives;
+
+    /*******************
+    * Finds the first word of the block a hash code belongs to
+    * @param  hash_in hash code of the key
+    * @return first word of the block
+    *******************/
+    unsigned int * findBlock(unsigned long long hash_in);
+
+    /*******************
+    * Copies the blocks and counters of another filter, starting the blocks on a cache line of this one's storage
+    * @param  filter_in filter to copy
+    * @return 0 success
+    *******************/
+    int copy(const BloomFilter & filter_in);
+
+  public:
+    //Default constructor and destructor
+    BloomFilter();
+    ~BloomFilter();
+
+    //Copy constructor and assignment, the counters are read once and the blocks aligned again
+    BloomFilter(const BloomFilter & filter_in);
+    BloomFilter & operator=(const BloomFilter & filter_in);
+
+    /*******************
+    * Finds the number of bytes a filter needs to hold a number of keys at a false positive rate
+    * @param  numKeys_in           number of keys to hold
+    * @param  falsePositiveRate_in chance of a key that was not added being passed, between 0 and 1
+    * @return number of bytes needed
+    *******************/
+    static size_t bytesNeeded(size_t numKeys_in, double falsePositiveRate_in);
+
+    /*******************
+    * Empties the filter and sizes it, replacing anything stored
+    * @param  numBytes_in number of bytes to use, rounded up to a whole block
+    * @return 0 success
+    *******************/
+    int reset(size_t numBytes_in);
+
+    /*******************
+    * Adds the hash code of a key to the filter
+    * @param  hash_in hash code of the key
+    * @return 0 success
+    *******************/
+    int add(unsigned long long hash_in);
+
+    /*******************
+    * Checks if the hash code of a key may have been added, counting the check
+    * @param  hash_in hash code of the key
+    * @return 0 key was never added
+    * @return 1 key may have been added
+    *******************/
+    int contains(unsigned long long hash_in);
+
+    /*******************
+    * Counts a key the filter passed that turned out not to be stored
+    * @return 0 success
+    *******************/
+    int recordFalsePositive();
+
+    /*******************
+    * Finds the counters and size of the filter
+    * @param  location_in location to store the counters
+    * @return 0 success
+    *******************/
+    int getStats(BloomStats * location_in);
+
+    /*******************
+    * Finds the number of blocks in the filter
+    * @return number of blocks, 0 if the filter is empty
+    *******************/
+    size_t size();
+  };
+
+};
+
+#endif
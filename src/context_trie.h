@@ -0,0 +1,154 @@
+/**************************************************************
+* A trie of ngrams of token identifiers where every length
+* shares the nodes of the shorter ngrams that begin it
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Added packing the values into as few bits as they need
+**************************************************************/
+
+#ifndef _H_CONTEXT_TRIE
+#define _H_CONTEXT_TRIE
+
+#include <vector>    //std::vector
+#include <algorithm> //std::sort()   std::lower_bound()
+
+#include "lexicon.h"
+#include "ngram_table.h"
+#include "packed_counts.h"
+
+namespace nlp {
+
+  template <typename Value> class ContextTrie {
+  private:
+    /* Identifier of the last token of each node of each length, the index is the length minus 1.
+       The nodes of a length are sorted by their parent and then by identifier, so they are in
+       the sorted order of their ngrams. The nodes of length 1 are indexed by identifier instead */
+    std::vector<std::vector<TokenId>> words;
+
+    /* Value of each node of each length, nodes of length 1 that were never stored hold Value().
+       Each length is emptied once its values are packed */
+    std::vector<std::vector<Value>> values;
+
+    /* Values of each length packed by pack, empty until then */
+    std::vector<PackedCounts> packed;
+
+    /* Index of the first child of each node of each length but the longest, the children of a node
+       end where the children of the next node begin so each has one more entry than there are nodes */
+    std::vector<std::vector<unsigned int>> children;
+
+    /* Number of ngrams stored of each length */
+    std::vector<int> numEntries;
+
+    /* Number of nodes of length 1, one more than the largest identifier */
+    int numIds;
+
+    /*******************
+    * Finds the child of a node with the specified identifier
+    * @param  length_in length of the parent node
+    * @param  parent_in index of the parent node
+    * @param  id_in     identifier of the child to find
+    * @return index of the child or -1 if it does not exist
+    *******************/
+    int findChild(int length_in, int parent_in, TokenId id_in);
+
+    /*******************
+    * Finds the node of an ngram by descending from its first token. Every identifier has a node
+    * of length 1 whether or not it was stored
+    * @param  key_in    identifiers of the ngram
+    * @param  length_in number of identifiers in the ngram
+    * @return index of the node or -1 if the ngram has no node
+    *******************/
+    int findPath(const TokenId * key_in, int length_in);
+
+    /*******************
+    * Finds the value of a node from its values or from its packed values
+    * @param  level_in length of the node minus 1
+    * @param  node_in  index of the node
+    * @return value of the node
+    *******************/
+    Value nodeValue(int level_in, int node_in);
+
+  public:
+    //Default constructor and destructor
+    ContextTrie();
+    ~ContextTrie();
+
+    /*******************
+    * Builds the trie from a table of each length from 1 to the longest, replacing anything stored.
+    * Every ngram has to have the ngram made of all but its last token in the table before it
+    * @param  tables_in table of each length, in increasing order starting at 1
+    * @param  numIds_in one more than the largest identifier in the tables
+    * @return 0  success
+    * @return -1 the tables do not start at 1 and increase by one or an ngram's context is missing
+    *******************/
+    int build(std::vector<NgramTable<Value>*> * tables_in, int numIds_in);
+
+    /*******************
+    * Packs the values of every length into as few bits as the largest of them needs, with values
+    * of 1 taking a single bit, and releases the unpacked values. Value has to be an integer type
+    * that is never negative
+    * @return 0 success
+    *******************/
+    int pack();
+
+    /*******************
+    * Finds the node of a stored ngram. The nodes of a length are numbered from 0 in sorted
+    * order, the nodes of length 1 by their identifier
+    * @param  key_in    identifiers of the ngram
+    * @param  length_in number of identifiers in the ngram
+    * @return index of the node or -1 if the ngram is not stored
+    *******************/
+    int find(const TokenId * key_in, int length_in);
+
+    /*******************
+    * Finds the value stored at a node
+    * @param  length_in length of the ngram of the node
+    * @param  node_in   index of the node found by find
+    * @return value of the node
+    *******************/
+    Value getValue(int length_in, int node_in);
+
+    /*******************
+    * Descends the trie along an ngram, storing the value of each of its beginnings.
+    * values_out[i] holds the value of the first i + 1 identifiers
+    * @param  key_in     identifiers of the ngram
+    * @param  length_in  number of identifiers in the ngram
+    * @param  values_out location to store length_in values, Value() for beginnings that are not stored
+    * @return number of beginnings that are stored
+    *******************/
+    int descend(const TokenId * key_in, int length_in, Value * values_out);
+
+    /*******************
+    * Calls a function with every ngram of a length in sorted order
+    * @param  length_in   length of the ngrams to visit
+    * @param  function_in function taking (const TokenId * key, Value value)
+    * @return 0 success
+    *******************/
+    template <typename Function> int forEach(int length_in, Function function_in);
+
+    /*******************
+    * Finds the number of ngrams of a length stored in the trie
+    * @param  length_in length of the ngrams to count
+    * @return number of ngrams of the length
+    *******************/
+    int size(int length_in);
+
+    /*******************
+    * Finds the longest length stored in the trie
+    * @return longest length or 0 if the trie is empty
+    *******************/
+    int getLength();
+
+    /*******************
+    * Finds the number of bytes used by the nodes of the trie and their values, packed or not
+    * @return bytes used by the trie
+    *******************/
+    size_t memoryUsage();
+  };
+
+};
+
+#endif
@@ -0,0 +1,275 @@
+//A trie of ngrams of token identifiers where every length shares the nodes of the shorter ngrams that begin it
+
+#ifndef _T_CONTEXT_TRIE
+#define _T_CONTEXT_TRIE
+
+#include "context_trie.h"
+
+namespace nlp {
+
+  //Finds the child of a node with the specified identifier
+  template <typename Value> int ContextTrie<Value>::findChild(int length_in, int parent_in, TokenId id_in) {
+    const std::vector<TokenId> & childWords = words[length_in];
+    std::vector<TokenId>::const_iterator first;
+    std::vector<TokenId>::const_iterator last;
+    std::vector<TokenId>::const_iterator result;
+
+    //The children of a node are sorted so they are binary searched
+    first = childWords.begin() + children[length_in - 1][parent_in];
+    last = childWords.begin() + children[length_in - 1][parent_in + 1];
+    result = std::lower_bound(first, last, id_in);
+    if (result == last || *result != id_in) {
+      return -1;
+    }
+
+    return (int) (result - childWords.begin());
+  }
+
+  //Finds the node of an ngram by descending from its first token
+  template <typename Value> int ContextTrie<Value>::findPath(const TokenId * key_in, int length_in) {
+    int node;
+    int lengthIterator;
+
+    if (length_in < 1 || length_in > (int) values.size() || key_in[0] >= (TokenId) numIds) {
+      return -1;
+    }
+
+    //Nodes of length 1 are found directly by their identifier
+    node = (int) key_in[0];
+    for (lengthIterator = 1; lengthIterator < length_in && node >= 0; ++lengthIterator) {
+      node = findChild(lengthIterator, node, key_in[lengthIterator]);
+    }
+
+    return node;
+  }
+
+  //Finds the value of a node from its values or from its packed values
+  template <typename Value> Value ContextTrie<Value>::nodeValue(int level_in, int node_in) {
+    if (! packed.empty()) {
+      return (Value) packed[level_in].get(node_in);
+    }
+    return values[level_in][node_in];
+  }
+
+  //Builds the trie from a table of each length from 1 to the longest
+  template <typename Value> int ContextTrie<Value>::build(std::vector<NgramTable<Value>*> * tables_in, int numIds_in) {
+    std::vector<std::pair<const TokenId *, Value>> sorted;
+    int lengthIterator;
+    int nodeIterator;
+    int parent;
+    int length;
+
+    words.clear();
+    values.clear();
+    packed.clear();
+    children.clear();
+    numEntries.clear();
+    numIds = 0;
+    for (lengthIterator = 0; lengthIterator < (int) tables_in->size(); ++lengthIterator) {
+      if ((*tables_in)[lengthIterator]->getLength() != lengthIterator + 1) {
+        return -1;
+      }
+    }
+    if (tables_in->empty()) {
+      return 0;
+    }
+    words.resize(tables_in->size());
+    values.resize(tables_in->size());
+    children.resize(tables_in->size());
+
+    //Nodes of length 1 are indexed by their identifier
+    numIds = numIds_in;
+    values[0].assign(numIds_in, Value());
+    for (auto iterator = (*tables_in)[0]->begin(); iterator != (*tables_in)[0]->end(); ++iterator) {
+      values[0][iterator.key()[0]] = iterator.value();
+    }
+    numEntries.push_back((*tables_in)[0]->size());
+
+    for (lengthIterator = 1; lengthIterator < (int) tables_in->size(); ++lengthIterator) {
+      NgramTable<Value> & table = *(*tables_in)[lengthIterator];
+      length = lengthIterator + 1;
+
+      //Sorting the ngrams puts the children of each node next to each other in the order of their parents
+      sorted.clear();
+      sorted.reserve(table.size());
+      for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+        sorted.push_back(std::make_pair((const TokenId *) iterator.key(), iterator.value()));
+      }
+      std::sort(sorted.begin(), sorted.end(), [length](const std::pair<const TokenId *, Value> & first, const std::pair<const TokenId *, Value> & second) {
+        return std::lexicographical_compare(first.first, first.first + length, second.first, second.first + length);
+      });
+
+      children[lengthIterator - 1].assign(values[lengthIterator - 1].size() + 1, 0);
+      words[lengthIterator].reserve(sorted.size());
+      values[lengthIterator].reserve(sorted.size());
+      for (nodeIterator = 0; nodeIterator < (int) sorted.size(); ++nodeIterator) {
+        parent = findPath(sorted[nodeIterator].first, length - 1);
+        if (parent < 0) {
+          words.clear();
+          values.clear();
+          children.clear();
+          numEntries.clear();
+          numIds = 0;
+          return -1;
+        }
+        //Count the children of each parent, the counts become offsets below
+        ++children[lengthIterator - 1][parent + 1];
+        words[lengthIterator].push_back(sorted[nodeIterator].first[lengthIterator]);
+        values[lengthIterator].push_back(sorted[nodeIterator].second);
+      }
+      for (nodeIterator = 1; nodeIterator < (int) children[lengthIterator - 1].size(); ++nodeIterator) {
+        children[lengthIterator - 1][nodeIterator] += children[lengthIterator - 1][nodeIterator - 1];
+      }
+      numEntries.push_back((int) sorted.size());
+    }
+
+    return 0;
+  }
+
+  //Packs the values of every length into as few bits as the largest of them needs
+  template <typename Value> int ContextTrie<Value>::pack() {
+    std::vector<unsigned int> numbers;
+    int lengthIterator;
+    size_t nodeIterator;
+
+    if (! packed.empty()) {
+      return 0;
+    }
+    packed.resize(values.size());
+    for (lengthIterator = 0; lengthIterator < (int) values.size(); ++lengthIterator) {
+      numbers.resize(values[lengthIterator].size());
+      for (nodeIterator = 0; nodeIterator < values[lengthIterator].size(); ++nodeIterator) {
+        numbers[nodeIterator] = (unsigned int) values[lengthIterator][nodeIterator];
+      }
+      packed[lengthIterator].assign(&numbers);
+      //Swapping with an empty list releases the memory where clear would keep it
+      std::vector<Value>().swap(values[lengthIterator]);
+    }
+
+    return 0;
+  }
+
+  //Finds the node of a stored ngram
+  template <typename Value> int ContextTrie<Value>::find(const TokenId * key_in, int length_in) {
+    int node;
+
+    node = findPath(key_in, length_in);
+    //Nodes of length 1 exist for every identifier but only some were stored
+    if (node < 0 || (length_in == 1 && nodeValue(0, node) == Value())) {
+      return -1;
+    }
+
+    return node;
+  }
+
+  //Finds the value stored at a node
+  template <typename Value> Value ContextTrie<Value>::getValue(int length_in, int node_in) {
+    return nodeValue(length_in - 1, node_in);
+  }
+
+  //Descends the trie along an ngram, storing the value of each of its beginnings
+  template <typename Value> int ContextTrie<Value>::descend(const TokenId * key_in, int length_in, Value * values_out) {
+    int lengthIterator;
+    int numFound;
+    int node;
+
+    numFound = 0;
+    node = -1;
+    if (! values.empty() && key_in[0] < (TokenId) numIds && nodeValue(0, key_in[0]) != Value()) {
+      node = (int) key_in[0];
+    }
+    for (lengthIterator = 0; lengthIterator < length_in; ++lengthIterator) {
+      if (lengthIterator > 0 && node >= 0) {
+        node = lengthIterator < (int) values.size() ? findChild(lengthIterator, node, key_in[lengthIterator]) : -1;
+      }
+      if (node < 0) {
+        values_out[lengthIterator] = Value();
+        continue;
+      }
+      values_out[lengthIterator] = nodeValue(lengthIterator, node);
+      ++numFound;
+    }
+
+    return numFound;
+  }
+
+  //Calls a function with every ngram of a length in sorted order
+  template <typename Value> template <typename Function> int ContextTrie<Value>::forEach(int length_in, Function function_in) {
+    std::vector<TokenId> key;
+    std::vector<unsigned int> ancestors;
+    unsigned int node;
+    unsigned int target;
+    int lengthIterator;
+    int level;
+
+    if (length_in < 1 || length_in > (int) values.size()) {
+      return 0;
+    }
+    key.resize(length_in);
+    level = length_in - 1;
+
+    if (level == 0) {
+      for (node = 0; node < (unsigned int) numIds; ++node) {
+        if (nodeValue(0, node) != Value()) {
+          key[0] = node;
+          function_in(key.data(), nodeValue(0, node));
+        }
+      }
+      return 0;
+    }
+
+    //The nodes are visited in order so each ancestor only ever moves forward
+    ancestors.assign(level, 0);
+    for (node = 0; node < (unsigned int) numEntries[level]; ++node) {
+      for (lengthIterator = level - 1; lengthIterator >= 0; --lengthIterator) {
+        target = lengthIterator == level - 1 ? node : ancestors[lengthIterator + 1];
+        while (children[lengthIterator][ancestors[lengthIterator] + 1] <= target) {
+          ++ancestors[lengthIterator];
+        }
+      }
+      key[0] = ancestors[0];
+      for (lengthIterator = 1; lengthIterator < level; ++lengthIterator) {
+        key[lengthIterator] = words[lengthIterator][ancestors[lengthIterator]];
+      }
+      key[level] = words[level][node];
+      function_in(key.data(), nodeValue(level, node));
+    }
+
+    return 0;
+  }
+
+  //Finds the number of ngrams of a length stored in the trie
+  template <typename Value> int ContextTrie<Value>::size(int length_in) {
+    if (length_in < 1 || length_in > (int) numEntries.size()) {
+      return 0;
+    }
+    return numEntries[length_in - 1];
+  }
+
+  //Finds the longest length stored in the trie
+  template <typename Value> int ContextTrie<Value>::getLength() {
+    return (int) values.size();
+  }
+
+  //Finds the number of bytes used by the nodes of the trie
+  template <typename Value> size_t ContextTrie<Value>::memoryUsage() {
+    size_t result;
+    int lengthIterator;
+
+    result = 0;
+    for (lengthIterator = 0; lengthIterator < (int) values.size(); ++lengthIterator) {
+      result += words[lengthIterator].capacity() * sizeof(TokenId);
+      result += values[lengthIterator].capacity() * sizeof(Value);
+      result += children[lengthIterator].capacity() * sizeof(unsigned int);
+      result += packed.empty() ? 0 : packed[lengthIterator].memoryUsage();
+    }
+
+    return result;
+  }
+
+  //Default constructor and destructor
+  template <typename Value> ContextTrie<Value>::ContextTrie() :numIds(0) {}
+  template <typename Value> ContextTrie<Value>::~ContextTrie() {}
+};
+
+#endif
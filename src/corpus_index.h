@@ -0,0 +1,185 @@
+/**************************************************************
+* An inverted index from the ngrams of many documents to the
+* documents that contain them
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_CORPUS_INDEX
+#define _H_CORPUS_INDEX
+
+#include <vector>    //std::vector
+#include <utility>   //std::pair
+#include <algorithm> //std::sort()   std::partial_sort()   std::find()
+
+#include "lexicon.t.h"
+#include "ngram_table.t.h"
+
+namespace nlp {
+
+  /* A document holding an ngram and how many times it occurs there */
+  struct Posting {
+    int document;
+    int count;
+  };
+
+  template <typename Type> class CorpusIndex {
+  private:
+    /* Postings of one ngram while documents are still being added. Each posting is stored as the
+       difference from the previous document then the count, both as variable length numbers */
+    struct PostingList {
+      std::vector<unsigned char> bytes;
+      int lastDocument;
+      int numDocuments;
+    };
+
+    /* Tokens of every document and their identifiers */
+    Lexicon<Type> lexicon;
+
+    /* The ngram lengths that are indexed */
+    std::vector<int> ngramLengths;
+
+    /* Index of the posting list of every ngram, one table per length in the order of ngramLengths */
+    std::vector<NgramTable<int>> listIndexes;
+
+    /* Posting lists of every ngram of each length, emptied once the index is packed */
+    std::vector<std::vector<PostingList>> postings;
+
+    /* Posting lists of each length one after another once the index is packed */
+    std::vector<std::vector<unsigned char>> packed;
+
+    /* Start of each posting list in packed, with one more entry for the end */
+    std::vector<std::vector<size_t>> packedStarts;
+
+    /* Number of documents in each packed posting list */
+    std::vector<std::vector<int>> packedSizes;
+
+    /* Number of documents added */
+    int numDocuments;
+
+    /*******************
+    * Appends a number to a list of bytes using as few bytes as it needs, 7 bits per byte
+    * @param  number_in   number to append
+    * @param  location_in location to append the bytes to
+    * @return 0 success
+    *******************/
+    static int appendNumber(unsigned int number_in, std::vector<unsigned char> * location_in);
+
+    /*******************
+    * Reads a number written by appendNumber
+    * @param  bytes_in    first byte of the number
+    * @param  location_in location to store the number
+    * @return the byte just after the number
+    *******************/
+    static const unsigned char * readNumber(const unsigned char * bytes_in, unsigned int * location_in);
+
+    /*******************
+    * Finds the index of an ngram length in ngramLengths
+    * @param  length_in length to find the index of
+    * @return index of the length or -1 if it is not indexed
+    *******************/
+    int getIndex(int length_in);
+
+    /*******************
+    * Finds the encoded posting list of an ngram of identifiers
+    * @param  key_in          identifiers of the ngram
+    * @param  length_in       number of identifiers in the ngram
+    * @param  begin_out       location to store the first byte of the list
+    * @param  end_out         location to store the byte just past the list
+    * @return number of documents in the list, 0 if the ngram is in none
+    *******************/
+    int findList(const TokenId * key_in, int length_in, const unsigned char ** begin_out, const unsigned char ** end_out);
+
+    /*******************
+    * Decodes an encoded posting list
+    * @param  begin_in    first byte of the list
+    * @param  end_in      byte just past the list
+    * @param  location_in location to store the postings, sorted by document
+    * @return 0 success
+    *******************/
+    static int decodeList(const unsigned char * begin_in, const unsigned char * end_in, std::vector<Posting> * location_in);
+
+  public:
+    /*******************
+    * Creates a new empty index of ngrams of the specified lengths
+    * @param gramLengths_in the lengths of ngrams to index
+    *******************/
+    CorpusIndex(std::vector<int> * gramLengths_in);
+
+    //Default constructor and destructor
+    CorpusIndex();
+    ~CorpusIndex();
+
+    /*******************
+    * Adds a document to the index, counting the ngrams of every indexed length in its tokens
+    * @param  tokens_in tokens of the document
+    * @return identifier of the document, the number of documents added before it
+    * @return -1 the index has been packed and can not change
+    *******************/
+    int addDocument(std::vector<Type> * tokens_in);
+
+    /*******************
+    * Moves every posting list of each length into one block of bytes, which releases the
+    * overhead of a list per ngram. No documents can be added afterwards
+    * @return 0 success
+    *******************/
+    int pack();
+
+    /*******************
+    * Finds the documents that contain an ngram and how many times each contains it
+    * @param  ngram_in    ngram to find, its length has to be indexed
+    * @param  location_in location to store the postings, sorted by document
+    * @return 0  success
+    * @return -1 the length of the ngram is not indexed
+    *******************/
+    int findDocuments(std::vector<Type> * ngram_in, std::vector<Posting> * location_in);
+
+    /*******************
+    * Finds the documents that contain a sentence in the sense of Document::hasSentence, where every
+    * ngram of up to the specified length ending at each token of the sentence has to occur
+    * @param  ngramLength_in length of ngrams to check, it and every shorter length used have to be indexed
+    * @param  sentence_in    sentence to find
+    * @param  location_in    location to store the identifiers of the documents, sorted
+    * @return 0  success
+    * @return -1 a length that is needed is not indexed
+    *******************/
+    int findSentence(int ngramLength_in, std::vector<Type> * sentence_in, std::vector<int> * location_in);
+
+    /*******************
+    * Finds the documents sharing the most distinct ngrams of a length with some text, as
+    * Document::numCommon would count them against each document in turn
+    * @param  length_in   length of the ngrams to compare, it has to be indexed
+    * @param  tokens_in   tokens of the text to compare
+    * @param  numResults_in most documents to find
+    * @param  location_in location to store (document, shared ngrams) pairs, most shared first
+    * @return 0  success
+    * @return -1 the length is not indexed
+    *******************/
+    int topDocuments(int length_in, std::vector<Type> * tokens_in, int numResults_in, std::vector<std::pair<int, int>> * location_in);
+
+    /*******************
+    * Finds the number of documents added to the index
+    * @return number of documents
+    *******************/
+    int size();
+
+    /*******************
+    * Finds the number of bytes used by the posting lists and the tables finding them
+    * @return bytes used by the index, not counting the lexicon
+    *******************/
+    size_t memoryUsage();
+
+    /*******************
+    * Finds the lexicon mapping the tokens of every document to their identifiers
+    * @return the index's lexicon
+    *******************/
+    Lexicon<Type> * getLexicon();
+  };
+
+};
+
+#endif
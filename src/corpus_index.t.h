@@ -0,0 +1,355 @@
+//An inverted index from the ngrams of many documents to the documents that contain them
+
+#ifndef _T_CORPUS_INDEX
+#define _T_CORPUS_INDEX
+
+#include "corpus_index.h"
+
+namespace nlp {
+
+  //Appends a number to a list of bytes using as few bytes as it needs
+  template <typename Type> int CorpusIndex<Type>::appendNumber(unsigned int number_in, std::vector<unsigned char> * location_in) {
+    //The high bit of each byte says if another byte follows
+    while (number_in >= 0x80) {
+      location_in->push_back((unsigned char) (number_in | 0x80));
+      number_in >>= 7;
+    }
+    location_in->push_back((unsigned char) number_in);
+
+    return 0;
+  }
+
+  //Reads a number written by appendNumber
+  template <typename Type> const unsigned char * CorpusIndex<Type>::readNumber(const unsigned char * bytes_in, unsigned int * location_in) {
+    unsigned int result;
+    int shift;
+
+    result = 0;
+    shift = 0;
+    while (*bytes_in & 0x80) {
+      result |= (unsigned int) (*bytes_in & 0x7F) << shift;
+      shift += 7;
+      ++bytes_in;
+    }
+    *location_in = result | ((unsigned int) *bytes_in << shift);
+
+    return bytes_in + 1;
+  }
+
+  //Finds the index of an ngram length in ngramLengths
+  template <typename Type> int CorpusIndex<Type>::getIndex(int length_in) {
+    auto result = std::find(ngramLengths.begin(), ngramLengths.end(), length_in);
+    return result == ngramLengths.end() ? -1 : (int) (result - ngramLengths.begin());
+  }
+
+  //Finds the encoded posting list of an ngram of identifiers
+  template <typename Type> int CorpusIndex<Type>::findList(const TokenId * key_in, int length_in, const unsigned char ** begin_out, const unsigned char ** end_out) {
+    int * list;
+    int index;
+
+    index = getIndex(length_in);
+    list = index < 0 ? NULL : listIndexes[index].find(key_in);
+    if (list == NULL) {
+      return 0;
+    }
+
+    //A packed index finds the list in the block of its length
+    if (! packed.empty()) {
+      *begin_out = packed[index].data() + packedStarts[index][*list];
+      *end_out = packed[index].data() + packedStarts[index][*list + 1];
+      return packedSizes[index][*list];
+    }
+    PostingList & current = postings[index][*list];
+    *begin_out = current.bytes.data();
+    *end_out = current.bytes.data() + current.bytes.size();
+
+    return current.numDocuments;
+  }
+
+  //Decodes an encoded posting list
+  template <typename Type> int CorpusIndex<Type>::decodeList(const unsigned char * begin_in, const unsigned char * end_in, std::vector<Posting> * location_in) {
+    Posting posting;
+    unsigned int number;
+
+    location_in->clear();
+    posting.document = -1;
+    while (begin_in < end_in) {
+      begin_in = readNumber(begin_in, &number);
+      posting.document += (int) number;
+      begin_in = readNumber(begin_in, &number);
+      posting.count = (int) number;
+      location_in->push_back(posting);
+    }
+
+    return 0;
+  }
+
+  //Adds a document to the index
+  template <typename Type> int CorpusIndex<Type>::addDocument(std::vector<Type> * tokens_in) {
+    std::vector<TokenId> ids;
+    int lengthIterator;
+    int tokenIterator;
+    int length;
+
+    if (! packed.empty()) {
+      return -1;
+    }
+    lexicon.addTokens(tokens_in, &ids);
+
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      length = ngramLengths[lengthIterator];
+      //The document is counted on its own first so each ngram gets one posting however often it occurs
+      NgramTable<int> counts(length);
+      for (tokenIterator = 0; tokenIterator + length <= (int) ids.size(); ++tokenIterator) {
+        *counts.insert(&ids[tokenIterator]) += 1;
+      }
+
+      NgramTable<int> & indexes = listIndexes[lengthIterator];
+      std::vector<PostingList> & lists = postings[lengthIterator];
+      for (auto iterator = counts.begin(); iterator != counts.end(); ++iterator) {
+        int * list = indexes.find(iterator.key());
+        if (list == NULL) {
+          list = indexes.insert(iterator.key());
+          *list = (int) lists.size();
+          lists.push_back(PostingList());
+          lists.back().lastDocument = -1;
+          lists.back().numDocuments = 0;
+        }
+        //Documents are added in order so every difference is positive
+        PostingList & current = lists[*list];
+        appendNumber((unsigned int) (numDocuments - current.lastDocument), &current.bytes);
+        appendNumber((unsigned int) iterator.value(), &current.bytes);
+        current.lastDocument = numDocuments;
+        ++current.numDocuments;
+      }
+    }
+
+    return numDocuments++;
+  }
+
+  //Moves every posting list of each length into one block of bytes
+  template <typename Type> int CorpusIndex<Type>::pack() {
+    int lengthIterator;
+    int listIterator;
+    size_t numBytes;
+
+    if (! packed.empty()) {
+      return 0;
+    }
+    packed.resize(ngramLengths.size());
+    packedStarts.resize(ngramLengths.size());
+    packedSizes.resize(ngramLengths.size());
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      std::vector<PostingList> & lists = postings[lengthIterator];
+      numBytes = 0;
+      for (listIterator = 0; listIterator < (int) lists.size(); ++listIterator) {
+        numBytes += lists[listIterator].bytes.size();
+      }
+      packed[lengthIterator].reserve(numBytes);
+      packedStarts[lengthIterator].reserve(lists.size() + 1);
+      packedSizes[lengthIterator].reserve(lists.size());
+      for (listIterator = 0; listIterator < (int) lists.size(); ++listIterator) {
+        packedStarts[lengthIterator].push_back(packed[lengthIterator].size());
+        packedSizes[lengthIterator].push_back(lists[listIterator].numDocuments);
+        packed[lengthIterator].insert(packed[lengthIterator].end(), lists[listIterator].bytes.begin(), lists[listIterator].bytes.end());
+      }
+      packedStarts[lengthIterator].push_back(packed[lengthIterator].size());
+      std::vector<PostingList>().swap(lists);
+    }
+
+    return 0;
+  }
+
+  //Finds the documents that contain an ngram
+  template <typename Type> int CorpusIndex<Type>::findDocuments(std::vector<Type> * ngram_in, std::vector<Posting> * location_in) {
+    std::vector<TokenId> ids;
+    const unsigned char * begin;
+    const unsigned char * end;
+
+    location_in->clear();
+    if (getIndex(ngram_in->size()) < 0) {
+      return -1;
+    }
+    //An ngram with a token no document has can not be in any
+    if (lexicon.findTokens(ngram_in, &ids) || findList(ids.data(), ids.size(), &begin, &end) == 0) {
+      return 0;
+    }
+
+    return decodeList(begin, end, location_in);
+  }
+
+  //Finds the documents that contain a sentence
+  template <typename Type> int CorpusIndex<Type>::findSentence(int ngramLength_in, std::vector<Type> * sentence_in, std::vector<int> * location_in) {
+    std::vector<std::pair<int, std::pair<const unsigned char *, const unsigned char *>>> lists;
+    std::vector<Posting> postingList;
+    std::vector<int> matches;
+    std::vector<TokenId> ids;
+    const unsigned char * begin;
+    const unsigned char * end;
+    int sentenceIterator;
+    int listIterator;
+    int postingIterator;
+    int matchIterator;
+    int numFound;
+    int start;
+
+    location_in->clear();
+    for (sentenceIterator = 1; sentenceIterator <= std::min(ngramLength_in, (int) sentence_in->size()); ++sentenceIterator) {
+      if (getIndex(sentenceIterator) < 0) {
+        return -1;
+      }
+    }
+    if (sentence_in->empty() || lexicon.findTokens(sentence_in, &ids)) {
+      return 0;
+    }
+
+    //Every ngram ends at a word of the sentence and is at most the specified length
+    for (sentenceIterator = 0; sentenceIterator < (int) ids.size(); ++sentenceIterator) {
+      start = sentenceIterator + 1 > ngramLength_in ? sentenceIterator + 1 - ngramLength_in : 0;
+      numFound = findList(&ids[start], sentenceIterator + 1 - start, &begin, &end);
+      if (numFound == 0) {
+        return 0;
+      }
+      lists.push_back(std::make_pair(numFound, std::make_pair(begin, end)));
+    }
+
+    //Intersecting from the rarest ngram keeps the candidates as few as possible
+    std::sort(lists.begin(), lists.end(), [](const std::pair<int, std::pair<const unsigned char *, const unsigned char *>> & first,
+      const std::pair<int, std::pair<const unsigned char *, const unsigned char *>> & second) {
+      return first.first < second.first;
+    });
+    decodeList(lists[0].second.first, lists[0].second.second, &postingList);
+    for (postingIterator = 0; postingIterator < (int) postingList.size(); ++postingIterator) {
+      location_in->push_back(postingList[postingIterator].document);
+    }
+    for (listIterator = 1; listIterator < (int) lists.size() && ! location_in->empty(); ++listIterator) {
+      decodeList(lists[listIterator].second.first, lists[listIterator].second.second, &postingList);
+      matches.clear();
+      matchIterator = 0;
+      //Both lists are sorted by document so one pass over each finds the documents in both
+      for (postingIterator = 0; postingIterator < (int) postingList.size() && matchIterator < (int) location_in->size(); ++postingIterator) {
+        while (matchIterator < (int) location_in->size() && (*location_in)[matchIterator] < postingList[postingIterator].document) {
+          ++matchIterator;
+        }
+        if (matchIterator < (int) location_in->size() && (*location_in)[matchIterator] == postingList[postingIterator].document) {
+          matches.push_back(postingList[postingIterator].document);
+        }
+      }
+      location_in->swap(matches);
+    }
+
+    return 0;
+  }
+
+  //Finds the documents sharing the most distinct ngrams of a length with some text
+  template <typename Type> int CorpusIndex<Type>::topDocuments(int length_in, std::vector<Type> * tokens_in, int numResults_in, std::vector<std::pair<int, int>> * location_in) {
+    std::vector<TokenId> ids;
+    std::vector<Posting> postingList;
+    std::vector<int> scores;
+    std::vector<int> touched;
+    const unsigned char * begin;
+    const unsigned char * end;
+    int tokenIterator;
+    int postingIterator;
+    int lastUnknown;
+    int document;
+
+    location_in->clear();
+    if (getIndex(length_in) < 0) {
+      return -1;
+    }
+
+    ids.resize(tokens_in->size());
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      ids[tokenIterator] = lexicon.findToken(&(*tokens_in)[tokenIterator]);
+    }
+
+    //Each distinct ngram of the text adds one to every document containing it
+    NgramTable<int> seen(length_in);
+    scores.assign(numDocuments, 0);
+    lastUnknown = -1;
+    for (tokenIterator = 0; tokenIterator < (int) ids.size(); ++tokenIterator) {
+      if (ids[tokenIterator] == UNKNOWN_TOKEN_ID) {
+        lastUnknown = tokenIterator;
+      }
+      //Ngrams holding a token no document has can not be shared
+      if (tokenIterator + 1 < length_in || lastUnknown > tokenIterator - length_in) {
+        continue;
+      }
+      int * visits = seen.insert(&ids[tokenIterator + 1 - length_in]);
+      if ((*visits)++ > 0 || findList(&ids[tokenIterator + 1 - length_in], length_in, &begin, &end) == 0) {
+        continue;
+      }
+      decodeList(begin, end, &postingList);
+      for (postingIterator = 0; postingIterator < (int) postingList.size(); ++postingIterator) {
+        document = postingList[postingIterator].document;
+        if (scores[document]++ == 0) {
+          touched.push_back(document);
+        }
+      }
+    }
+
+    //Only the documents that share something are ranked
+    for (postingIterator = 0; postingIterator < (int) touched.size(); ++postingIterator) {
+      location_in->push_back(std::make_pair(touched[postingIterator], scores[touched[postingIterator]]));
+    }
+    numResults_in = std::max(0, std::min(numResults_in, (int) location_in->size()));
+    std::partial_sort(location_in->begin(), location_in->begin() + numResults_in, location_in->end(), [](const std::pair<int, int> & first, const std::pair<int, int> & second) {
+      return first.second != second.second ? first.second > second.second : first.first < second.first;
+    });
+    location_in->resize(numResults_in);
+
+    return 0;
+  }
+
+  //Finds the number of documents added to the index
+  template <typename Type> int CorpusIndex<Type>::size() {
+    return numDocuments;
+  }
+
+  //Finds the number of bytes used by the posting lists and the tables finding them
+  template <typename Type> size_t CorpusIndex<Type>::memoryUsage() {
+    size_t result;
+    int lengthIterator;
+    int listIterator;
+
+    result = 0;
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      result += listIndexes[lengthIterator].memoryUsage();
+      result += postings[lengthIterator].capacity() * sizeof(PostingList);
+      for (listIterator = 0; listIterator < (int) postings[lengthIterator].size(); ++listIterator) {
+        result += postings[lengthIterator][listIterator].bytes.capacity();
+      }
+    }
+    for (lengthIterator = 0; lengthIterator < (int) packed.size(); ++lengthIterator) {
+      result += packed[lengthIterator].capacity();
+      result += packedStarts[lengthIterator].capacity() * sizeof(size_t);
+      result += packedSizes[lengthIterator].capacity() * sizeof(int);
+    }
+
+    return result;
+  }
+
+  //Finds the lexicon mapping the tokens of every document to their identifiers
+  template <typename Type> Lexicon<Type> * CorpusIndex<Type>::getLexicon() {
+    return &lexicon;
+  }
+
+  //Creates a new empty index of ngrams of the specified lengths
+  template <typename Type> CorpusIndex<Type>::CorpusIndex(std::vector<int> * gramLengths_in) {
+    int lengthIterator;
+
+    numDocuments = 0;
+    ngramLengths = *gramLengths_in;
+    postings.resize(ngramLengths.size());
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      listIndexes.push_back(NgramTable<int>(ngramLengths[lengthIterator]));
+    }
+  }
+
+  //Default constructor and destructor
+  template <typename Type> CorpusIndex<Type>::CorpusIndex() :numDocuments(0) {}
+  template <typename Type> CorpusIndex<Type>::~CorpusIndex() {}
+};
+
+#endif
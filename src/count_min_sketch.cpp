@@ -0,0 +1,123 @@
+//A count-min sketch of ngram hash codes that estimates counts in a fixed amount of memory however many ngrams are added
+
+#include <cmath> //log()   exp()
+
+#include "count_min_sketch.h"
+
+namespace nlp {
+
+  //Finds the counter of a hash code in a row
+  size_t CountMinSketch::findCounter(unsigned long long hash_in, int row_in) {
+    unsigned int current;
+
+    //Each row mixes the two halves of the hash differently, which is as good as a hash per row
+    current = (unsigned int) hash_in + (unsigned int) row_in * ((unsigned int) (hash_in >> 32) | 1);
+    current ^= current >> 15;
+    current *= 0x2C1B3C6Du;
+    current ^= current >> 12;
+
+    return row_in * width + (size_t) (((unsigned long long) current * width) >> 32);
+  }
+
+  //Empties the sketch and sizes it
+  int CountMinSketch::reset(size_t numBytes_in, int depth_in) {
+    depth = depth_in < 1 ? 1 : depth_in;
+    width = numBytes_in / (depth * sizeof(unsigned int));
+    width = width < 1 ? 1 : width;
+    numAdded = 0;
+    numOccupied = 0;
+    counters.assign(width * depth, 0);
+
+    return 0;
+  }
+
+  //Adds one occurance of a key
+  unsigned int CountMinSketch::add(unsigned long long hash_in) {
+    size_t indexes[SKETCH_DEPTH];
+    std::vector<size_t> moreIndexes;
+    size_t * location;
+    unsigned int result;
+    int rowIterator;
+
+    if (width == 0) {
+      return 0;
+    }
+    if (depth > SKETCH_DEPTH) {
+      moreIndexes.resize(depth);
+      location = moreIndexes.data();
+    } else {
+      location = indexes;
+    }
+
+    result = 0xFFFFFFFFu;
+    for (rowIterator = 0; rowIterator < depth; ++rowIterator) {
+      location[rowIterator] = findCounter(hash_in, rowIterator);
+      result = counters[location[rowIterator]] < result ? counters[location[rowIterator]] : result;
+    }
+    //Conservative update, counters already above the new estimate were raised by other keys
+    if (result < 0xFFFFFFFFu) {
+      ++result;
+    }
+    if (counters[location[0]] == 0) {
+      ++numOccupied;
+    }
+    for (rowIterator = 0; rowIterator < depth; ++rowIterator) {
+      if (counters[location[rowIterator]] < result) {
+        counters[location[rowIterator]] = result;
+      }
+    }
+    ++numAdded;
+
+    return result;
+  }
+
+  //Estimates the number of times a key was added
+  unsigned int CountMinSketch::estimate(unsigned long long hash_in) {
+    unsigned int result;
+    int rowIterator;
+
+    if (width == 0) {
+      return 0;
+    }
+    result = 0xFFFFFFFFu;
+    for (rowIterator = 0; rowIterator < depth; ++rowIterator) {
+      unsigned int current = counters[findCounter(hash_in, rowIterator)];
+      result = current < result ? current : result;
+    }
+
+    return result;
+  }
+
+  //Estimates the number of distinct keys added
+  size_t CountMinSketch::numDistinct() {
+    //Linear counting, a full row only shows that there are at least as many keys as counters
+    if (numOccupied >= width) {
+      return (size_t) (width * log((double) width));
+    }
+
+    return (size_t) (-(double) width * log(1 - (double) numOccupied / width) + 0.5);
+  }
+
+  //Finds the size and error bound of the sketch
+  int CountMinSketch::getStats(SketchStats * location_in) {
+    location_in->numBytes = counters.size() * sizeof(unsigned int);
+    location_in->width = width;
+    location_in->depth = depth;
+    location_in->numAdded = numAdded;
+    location_in->errorBound = width == 0 ? 0 : exp(1.0) / width * numAdded;
+    location_in->confidence = 1 - exp(-(double) depth);
+    location_in->numDistinct = width == 0 ? 0 : numDistinct();
+    location_in->numHeavy = 0;
+
+    return 0;
+  }
+
+  //Finds the number of counters in each row
+  size_t CountMinSketch::size() {
+    return width;
+  }
+
+  //Default constructor and destructor
+  CountMinSketch::CountMinSketch() :width(0), depth(0), numAdded(0), numOccupied(0) {}
+  CountMinSketch::~CountMinSketch() {}
+};
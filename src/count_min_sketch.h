@@ -0,0 +1,140 @@
+/**************************************************************
+* A count-min sketch of ngram hash codes that estimates counts
+* in a fixed amount of memory however many ngrams are added
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_COUNT_MIN_SKETCH
+#define _H_COUNT_MIN_SKETCH
+
+#include <vector>  //std::vector
+#include <cstddef> //size_t
+
+#define SKETCH_DEPTH 4
+
+namespace nlp {
+
+  /* How a document counts the ngrams of its longer lengths in sketches */
+  struct SketchOptions {
+    /* Bytes of the sketch of each sketched length */
+    size_t numBytes;
+
+    /* Number of rows of each sketch, SKETCH_DEPTH is a good default */
+    int depth;
+
+    /* Lengths up to this one are counted exactly in tables, so 1 keeps the unigrams exact */
+    int exactLength;
+
+    /* Least estimated count that moves an ngram into the exact table of its length, 0 to keep none */
+    int heavyCount;
+
+    /* Most ngrams the exact table of each sketched length may hold */
+    int maxHeavy;
+  };
+
+  /* Size and error bound of a sketch */
+  struct SketchStats {
+    /* Number of bytes used by the counters */
+    size_t numBytes;
+
+    /* Number of counters in each row and number of rows */
+    size_t width;
+    int depth;
+
+    /* Occurances added to the sketch */
+    unsigned long long numAdded;
+
+    /* An estimate is more than the true count by at most this much, e / width * numAdded ... */
+    double errorBound;
+
+    /* ... with this probability, 1 - e^-depth. Estimates are never less than the true count */
+    double confidence;
+
+    /* Estimated number of distinct keys added */
+    size_t numDistinct;
+
+    /* Ngrams of the length counted exactly in the document's table */
+    int numHeavy;
+  };
+
+  class CountMinSketch {
+  private:
+    /* Counters of every row one after another */
+    std::vector<unsigned int> counters;
+
+    /* Number of counters in each row */
+    size_t width;
+
+    /* Number of rows */
+    int depth;
+
+    /* Occurances added to the sketch */
+    unsigned long long numAdded;
+
+    /* Number of counters of the first row that are not 0, for estimating the distinct keys */
+    size_t numOccupied;
+
+    /*******************
+    * Finds the counter of a hash code in a row
+    * @param  hash_in hash code of the key
+    * @param  row_in  row to find the counter in
+    * @return index of the counter
+    *******************/
+    size_t findCounter(unsigned long long hash_in, int row_in);
+
+  public:
+    //Default constructor and destructor
+    CountMinSketch();
+    ~CountMinSketch();
+
+    /*******************
+    * Empties the sketch and sizes it, replacing anything stored
+    * @param  numBytes_in number of bytes to use across every row
+    * @param  depth_in    number of rows, each row lowers the chance of a large error
+    * @return 0 success
+    *******************/
+    int reset(size_t numBytes_in, int depth_in);
+
+    /*******************
+    * Adds one occurance of a key. Only the counters at the key's current estimate are raised, which
+    * keeps the bound of a plain count-min sketch and lowers the error of keys sharing counters
+    * @param  hash_in hash code of the key
+    * @return estimated count of the key after adding it
+    *******************/
+    unsigned int add(unsigned long long hash_in);
+
+    /*******************
+    * Estimates the number of times a key was added, never less than the true count
+    * @param  hash_in hash code of the key
+    * @return estimated count
+    *******************/
+    unsigned int estimate(unsigned long long hash_in);
+
+    /*******************
+    * Estimates the number of distinct keys added from the counters of the first row still at 0
+    * @return estimated number of distinct keys
+    *******************/
+    size_t numDistinct();
+
+    /*******************
+    * Finds the size and error bound of the sketch
+    * @param  location_in location to store the size and bound
+    * @return 0 success
+    *******************/
+    int getStats(SketchStats * location_in);
+
+    /*******************
+    * Finds the number of counters in each row
+    * @return number of counters, 0 if the sketch is empty
+    *******************/
+    size_t size();
+  };
+
+};
+
+#endif
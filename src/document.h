@@ -1,175 +1,782 @@
-/**************************************************************
-* A document for storing the nGram information of a file
-*
-* Created By: Nick DelBen
-* Created On: Feb 28, 2015
-*
-* Last Edited: March 6, 2015
-*   - Added readTokens() and refactored accordingly
-**************************************************************/
-
-#ifndef _H_DOCUMENT
-#define _H_DOCUMENT
-
-#include <string>        //std::string
-#include <vector>        //std::vector
-#include <unordered_map> //std::unordered_map
-#include <algorithm>     //std::sort()   std::find()
-
-#include "VectorHash.h"
-
-#define EOS "<END>"
-
-namespace nlp {
-
-  template <typename Type> class Document {
-  protected:
-    /* The amount of elements in each ngram for the document. */
-    std::vector<int> ngramLengths;
-
-    /* Dictionary to keep track of nGram occurances or varying lengths */
-    std::vector<std::unordered_map<std::vector<Type>, int>> dictionary;
-
-    /* Amount of tokens in the document */
-    int numTokens;
-
-    /* The tokens that were used to generate the document */
-    std::vector<Type> tokens;
-
-    /*******************
-     * Finds the index of a ngram length in the dictionary
-     * @param  length_in length to find index of
-     * @return index of the specified length
-     ******************/
-    int getIndex(int length_in);
-
-    /*******************
-    * Initilizes the values of the object
-    * @param tokens_in    tokens to create the document from
-    * @param gramLenghts_in the lengths to construct the dictionaries from
-    *******************/
-    int init_object(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in);
-
-  public:
-    /*******************
-    * Creates a new instance of Document finding all the ngrams 
-    * from size 1 to the specified number
-    * @param tokens_in    tokens to create the document from
-    * @param gramLenth_in longest nGrams to search for
-    *******************/
-    Document(std::vector<Type> * tokens_in, int gramLength_in);
-    /*******************
-    * Creates a new instance of Document finding all the ngrams 
-    * from a specified size to another specified size
-    * @param tokens_in    tokens to create the document from
-    * @param gramLenthLow_in  shortest nGrams to search for
-    * @param gramLenthHigh_in longest nGrams to search for
-    *******************/
-    Document(std::vector<Type> * tokens_in, int gramLengthLow_in, int gramLengthHigh_in);
-    /*******************
-    * Creates a new instance of Document finding all the ngrams 
-    * of the sizes specified in the inout vector
-    * @param tokens_in    tokens to create the document from
-    * @param gramLenghts_in the lengths to construct the dictionaries from
-    *******************/
-    Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in);
-
-    //Default constructor and destructor
-    Document();
-    ~Document();
-
-    /*******************
-    * Reads tokens of the specified lengths from the document's tokens
-    * @param  lengths_in ngram lengths to be created from the tokens
-    * @return 0 success
-    *******************/
-    int readTokens(std::vector<int> * lengths_in);
-
-    /*******************
-    * Reads tokens from lengths 1 to the specified length from the document's tokens
-    * @param  length_in ngram lengths to be created from the tokens
-    * @return 0 success
-    *******************/
-    int readTokens(int length_in);
-
-    /*******************
-    * Checks if grams of the specified length have been added to the dictionary
-    * @param  length_in the ngram length to check the dictionary for
-    * @return -1 invalid ngram length
-    * @return 0  ngrams of specified length have not been read
-    * @return 1  ngrams of specified length have been read
-    *******************/
-    int hasNgrams(int length_in);
-
-    /*******************
-    * Returns the number of ngrams of a specified length in the document
-    * @param  length_in  length of ngrams to get count for
-    * @return number of ngrams in the document
-    *******************/
-    int numNgrams(int length_in);
-
-    /*******************
-    * Returns the number of disctict ngrams in the document
-    * @param  length_in  length of ngrams to get count for
-    * @return number of distinct ngrams in the document
-    *******************/
-    int numDistinctNgrams(int length_in);
-
-    /*******************
-    * Finds the occurances of an ngram in the document
-    * @param  nGram_in ngram to check for existace
-    * @return number of occurances of nGram in dictionary
-    *******************/
-    int countNgram(std::vector<Type> * nGram_in);
-
-    /*******************
-    * Checks if an nGram occurs in this document
-    * @param  nGram_in ngram to check for existace
-    * @return 0 nGram is not in database
-    * @return 1 nGram is in database
-    *******************/
-    int hasNgram(std::vector<Type> * nGram_in);
-
-    /*******************
-    * Adds an nGram to the dictionary
-    * @param nGram_in ngram to add to the database
-    * @return 0 success
-    *******************/
-    int addNgram(std::vector<Type> * nGram_in);
-
-    /*******************
-    * Finds the number of ngrams in this document that are also in the specified document
-    * @param  length_in   ngram length to compare
-    * @param  document_in document to compare to
-    * @return number of common ngrams to both documents
-    ******************/
-    int numCommon(int length_in, Document * document_in);
-
-    /*******************
-    * Shows the ngrams of a specified length in this document that are also in a specifeid document
-    * @param  length_in   ngram length to compare
-    * @param  document_in document to compare to
-    * @param  result_in   location to store the common ngrams
-    * @return number of common ngrams to both documents
-    ******************/
-    int findCommon(int length_in, Document * document_in, std::vector<const std::vector<Type>*> * result_in);
-
-    /*******************
-    * Finds the number of unique ngram lengths stored in this document
-    * @return number of ngram lengths on th document
-    ******************/
-    int numLengths();
-
-    /******************
-    * Checks if the document contains the specified sentence
-    * @param  ngramLength_in length of ngrams to check
-    * @param  sentence_in    sentence to check the document for
-    * @return 0 sentence is not in document
-    * @return 1 sentence is in document
-    ******************/
-    int hasSentence(int ngramLength_in, std::vector<Type> * sentence_in);
-  };
-
-};
-
+/**************************************************************
+* A document for storing the nGram information of a file
+*
+* Created By: Nick DelBen
+* Created On: Feb 28, 2015
+*
+* Last Edited: October 18, 2026
+*   - Added packing the counts of the trie and quantizing probabilities
+**************************************************************/
+
+#ifndef _H_DOCUMENT
+#define _H_DOCUMENT
+
+#include <string>        //std::string
+#include <vector>        //std::vector
+#include <unordered_map> //std::unordered_map
+#include <algorithm>     //std::sort()   std::partial_sort()   std::find()
+#include <thread>        //std::thread
+#include <cstdio>        //fopen()   fprintf()
+#include <cmath>         //log10()   log()   exp()
+#include <cfloat>        //FLT_MAX
+#include <cstring>       //memmove()
+#include <atomic>        //std::atomic
+
+#include "VectorHash.h"
+#include "lexicon.t.h"
+#include "ngram_table.t.h"
+#include "context_trie.t.h"
+#include "bloom_filter.h"
+#include "quantized_values.h"
+#include "count_min_sketch.h"
+#include "minhash.t.h"
+#include "batch_scorer.t.h"
+#include "tokenSource.i.h"
+#include "model_file.h"
+
+#define STREAM_BUFFER_LENGTH 4096
+#define NGRAM_VIEW_LENGTH 32
+#define PRUNE_MAX_DISCOUNT 0.9
+
+namespace nlp {
+
+  /* Totals of the ngrams that continue a context, one token longer than it */
+  struct ContextTotals {
+    /* Occurances of the context itself */
+    int count;
+
+    /* Sum of the counts of the ngrams that begin with the context. This is one less than the count when
+       the context is also the last tokens of the document, since nothing follows it there */
+    int successorTotal;
+
+    /* Number of distinct tokens that follow the context */
+    int numSuccessors;
+  };
+
+  /* Ngrams of one length sorted by a fingerprint of their tokens, so the ngrams two documents share
+     are found by merging two lists rather than probing one table per ngram */
+  struct FingerprintList {
+    /* Fingerprint of each ngram, in increasing order. Equal fingerprints are checked token by token */
+    std::vector<unsigned long long> fingerprints;
+
+    /* Identifiers of each ngram in the same order, one after another */
+    std::vector<TokenId> keys;
+  };
+
+  /* Sizes of a document and perplexity of held out sentences before and after pruning */
+  struct PruneStats {
+    /* Distinct ngrams of each length, the index is the length minus 1 */
+    std::vector<int> numBefore;
+    std::vector<int> numAfter;
+
+    /* Bytes used by the tables of every length */
+    size_t bytesBefore;
+    size_t bytesAfter;
+
+    /* Least relative entropy an ngram needed to be kept */
+    double threshold;
+
+    /* Perplexity of the held out sentences, 0 when none were given */
+    double perplexityBefore;
+    double perplexityAfter;
+  };
+
+  template <typename Type> class Document {
+  protected:
+    /* The amount of elements in each ngram for the document. */
+    std::vector<int> ngramLengths;
+
+    /* Dictionary to keep track of nGram occurances or varying lengths */
+    std::vector<NgramTable<int>> dictionary;
+
+    /* Amount of tokens in the document */
+    int numTokens;
+
+    /* The identifiers of the tokens that were used to generate the document */
+    std::vector<TokenId> tokens;
+
+    /* Identifiers of the distinct tokens in the document */
+    Lexicon<Type> lexicon;
+
+    /* Number of threads used to count ngrams when reading tokens */
+    int numThreads;
+
+    /* Ngrams of each length read from a model file, empty unless the document was loaded from one */
+    std::vector<SortedNgrams> frozen;
+
+    /* Counts of every length packed into a trie, empty unless buildTrie was called */
+    ContextTrie<int> trie;
+
+    /* Totals of each context, the index is the length of the context minus 1. Empty unless buildTotals
+       was called, and emptied again when ngrams are added since the totals would be out of date */
+    std::vector<NgramTable<ContextTotals>> totals;
+
+    /* Bloom filter of each length in the same order as the dictionary. Empty unless buildFilters was
+       called, and emptied again when ngrams or lengths are added since a filter must hold every ngram */
+    std::vector<BloomFilter> filters;
+
+    /* Sorted fingerprints of each length in the same order as the dictionary. Empty unless buildFingerprints
+       was called, and emptied again when ngrams or lengths are added */
+    std::vector<FingerprintList> fingerprints;
+
+    /* How the document was told to count with sketches, a size of 0 bytes counts every length exactly */
+    SketchOptions sketchOptions;
+
+    /* Count-min sketch of each length in the same order as the dictionary, empty for lengths counted exactly.
+       The table of a sketched length only holds the heavy hitters moved out of the sketch */
+    std::vector<CountMinSketch> sketches;
+
+    /* Natural log of the probability of every node of the trie, the index is the length minus 1. Empty unless
+       a language model quantized its probabilities, and emptied again when its parameters change */
+    std::vector<QuantizedValues> quantized;
+
+    /*******************
+     * Finds the index of a ngram length in the dictionary
+     * @param  length_in length to find index of
+     * @return index of the specified length
+     ******************/
+    int getIndex(int length_in);
+
+    /*******************
+    * Initilizes the values of the object
+    * @param tokens_in    tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in   how to count with sketches, NULL to count every length exactly
+    * @param numThreads_in number of threads to count with
+    *******************/
+    int init_object(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, int numThreads_in);
+
+    /*******************
+    * Initilizes the values of the object once its token identifiers have been stored
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in   how to count with sketches, NULL to count every length exactly
+    * @param numThreads_in number of threads to count with
+    *******************/
+    int init_counts(std::vector<int> * gramLengths_in, SketchOptions * options_in, int numThreads_in);
+
+    /*******************
+    * Initilizes the values of the object by counting ngrams as tokens are read from a source,
+    * keeping only the tokens that start ngrams which have not been completed
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param keepTokens_in  if this is >0 the tokens are also stored so more lengths can be read later
+    * @param options_in     how to count with sketches, NULL to count every length exactly
+    *******************/
+    int init_stream(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, SketchOptions * options_in);
+
+    /*******************
+    * Initilizes the values of the object from a mapped model file
+    * @param model_in model file to query the counts from
+    *******************/
+    int init_model(ModelFile * model_in);
+
+    /*******************
+    * Writes the lexicon and the counts of every ngram length to a model file
+    * @param  fileName_in      name of the file to write
+    * @param  header_in        header with the values of the language model filled in
+    * @param  frequencies_in   (count, frequency) pairs of each length, may be empty
+    * @param  probabilities_in (count, probability) pairs of each length, may be empty
+    * @return 0  success
+    * @return -1 file could not be written or the document counts with sketches
+    *******************/
+    int writeModel(std::string fileName_in, ModelHeader * header_in, std::vector<std::vector<FrequencyPair>> * frequencies_in,
+      std::vector<std::vector<ProbabilityPair>> * probabilities_in);
+
+    /*******************
+    * Writes every stored ngram to a file in the ARPA format with the log10 of its probability
+    * given the tokens before it. No backoff weights are written since the language models
+    * of this library do not back off. The lengths must run from 1 to the longest length
+    * @param  fileName_in    name of the file to write
+    * @param  probability_in function taking (std::vector<Type> * ngram) and returning the
+    *                        probability of the last token given the tokens before it
+    * @return 0  success
+    * @return -1 file could not be written or a length is counted in a sketch
+    * @return -2 the lengths do not run from 1 to the longest length
+    *******************/
+    template <typename Function> int writeArpa(std::string fileName_in, Function probability_in);
+
+    /*******************
+    * Calls a function with the identifiers and count of every ngram of a length,
+    * whether the ngrams are stored in a table or in a model file
+    * @param  length_in   length of the ngrams to visit
+    * @param  function_in function taking (const TokenId * key, int count)
+    * @return 0  success
+    * @return -1 the length is counted in a sketch, which can not list its ngrams
+    *******************/
+    template <typename Function> int forEachNgram(int length_in, Function function_in);
+
+    /*******************
+    * Adds a table to the dictionary for each length that has not been read
+    * @param  lengths_in  lengths to add tables for
+    * @param  lengths_out location to store the added lengths, in increasing order
+    * @param  tables_out  location to store the added table of each length
+    * @return 0 success
+    *******************/
+    int addLengths(std::vector<int> * lengths_in, std::vector<int> * lengths_out, std::vector<NgramTable<int>*> * tables_out);
+
+    /*******************
+    * Finds the first of a sorted list of fingerprints that is not less than a target, checking
+    * 1, 2, 4... places ahead before searching between the last two, so the cost grows with the
+    * distance moved rather than the length of the list
+    * @param  values_in sorted fingerprints
+    * @param  begin_in  first place to check
+    * @param  end_in    place just past the last fingerprint
+    * @param  target_in fingerprint to find
+    * @return place of the first fingerprint not less than the target, end_in if there is none
+    *******************/
+    static size_t gallop(const unsigned long long * values_in, size_t begin_in, size_t end_in, unsigned long long target_in);
+
+    /*******************
+    * Finds the ngrams of a length two documents share by merging their sorted fingerprints
+    * @param  length_in   ngram length to compare, both documents need fingerprints of it
+    * @param  document_in document to compare to
+    * @param  result_in   location to store the common ngrams, may be NULL
+    * @return number of common ngrams to both documents
+    ******************/
+    int intersectFingerprints(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in);
+
+    /*******************
+    * Finds the ngrams of a length two documents share, merging fingerprints when both have them
+    * and probing the other document for every ngram otherwise
+    * @param  length_in   ngram length to compare, counted exactly in both documents
+    * @param  document_in document to compare to
+    * @param  result_in   location to store the common ngrams, may be NULL
+    * @return number of common ngrams to both documents
+    ******************/
+    int matchNgrams(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in);
+
+    /*******************
+    * Checks if a document has sorted fingerprints of a length
+    * @param  length_in length to check
+    * @return 1 the document has fingerprints of the length
+    * @return 0 it does not
+    ******************/
+    int hasFingerprints(int length_in);
+
+    /*******************
+    * Finds the overlap of rows of the matrix until none are left, each row comparing its
+    * document to every later one
+    * @param  length_in    ngram length to compare
+    * @param  documents_in documents to compare, every one with fingerprints of the length
+    * @param  next_in      next row to find
+    * @param  location_in  matrix to store the overlap in
+    * @return 0 success
+    ******************/
+    static int overlapRows(int length_in, std::vector<Document*> * documents_in, std::atomic<int> * next_in, std::vector<std::vector<int>> * location_in);
+
+    /* Relative entropy of an ngram for pruning, raised to the highest of the ngrams one token longer that
+       start or end with it since those can not be kept without it */
+    struct PruneScore {
+      float score;
+      float childScore;
+      int hasChildren;
+    };
+
+    /*******************
+    * Finds the bytes a table of ngrams would use once it holds a number of entries
+    * @param  length_in     length of the ngrams
+    * @param  numEntries_in number of entries
+    * @return bytes used by the table
+    *******************/
+    static size_t tableBytes(int length_in, int numEntries_in);
+
+    /*******************
+    * Finds the perplexity of a model on a list of sentences
+    * @param  model_in     model to score the sentences with
+    * @param  length_in    length of ngrams the model scores with
+    * @param  sentences_in sentences to score
+    * @return perplexity, infinity if a sentence has no probability and 0 if there are no tokens
+    *******************/
+    static double perplexity(LanguageModel<Type> * model_in, int length_in, std::vector<std::vector<Type>> * sentences_in);
+
+    /*******************
+    * Counts the ngrams starting at each of a run of token identifiers, sliding one
+    * window over the tokens and extending each hash code from the shorter lengths
+    * @param  tokens_in    identifiers of the tokens to count
+    * @param  numStarts_in number of tokens to count ngrams starting at
+    * @param  numTokens_in number of tokens available to the ngrams
+    * @param  lengths_in   ngram lengths to count, in increasing order
+    * @param  tables_in    table to count each length into
+    * @return 0 success
+    *******************/
+    int countNgrams(const TokenId * tokens_in, int numStarts_in, int numTokens_in, std::vector<int> * lengths_in, std::vector<NgramTable<int>*> * tables_in);
+
+    /*******************
+    * Counts the ngrams of the whole document across multiple threads. Each thread counts
+    * a chunk of the tokens into its own tables, reading past the end of its chunk for the
+    * ngrams that overlap the next one, and the tables are then merged one length per thread
+    * @param  lengths_in ngram lengths to count, in increasing order
+    * @param  tables_in  table to count each length into
+    * @return 0 success
+    *******************/
+    int countNgramsParallel(std::vector<int> * lengths_in, std::vector<NgramTable<int>*> * tables_in);
+
+    /*******************
+    * Counts one occurance of an ngram of a sketched length. Ngrams in the table are counted exactly,
+    * the rest are added to the sketch and moved into the table once their estimate reaches the heavy count
+    * @param  table_in  table of the heavy hitters of the length
+    * @param  sketch_in sketch of the length
+    * @param  key_in    identifiers of the ngram
+    * @param  hash_in   hash code of the ngram
+    * @return 0 success
+    *******************/
+    int countSketched(NgramTable<int> * table_in, CountMinSketch * sketch_in, const TokenId * key_in, NgramHash hash_in);
+
+    /*******************
+    * Finds the occurances of an ngram of token identifiers in the document
+    * @param  nGram_in ngram of identifiers to check for existance
+    * @return number of occurances of nGram in dictionary
+    *******************/
+    int countIds(std::vector<TokenId> * nGram_in);
+
+    /*******************
+    * Finds the occurances of the first identifiers of an ngram in the document
+    * @param  nGram_in  identifiers of the ngram
+    * @param  length_in number of identifiers to count the occurances of
+    * @return number of occurances of the identifiers in dictionary
+    *******************/
+    int countIds(const TokenId * nGram_in, int length_in);
+
+    /*******************
+    * Finds the occurances of an ngram of identifiers and of the context it begins with.
+    * A document packed into a trie finds both in one descent of it, and a document with context totals finds the count of the context
+    * in its totals and only probes for the ngram when something follows the context
+    * @param  nGram_in        identifiers of the ngram
+    * @param  givenLength_in  number of identifiers in the context
+    * @param  givenCount_out  location to store the occurances of the context
+    * @return number of occurances of the ngram in the dictionary
+    *******************/
+    int countIdsGiven(std::vector<TokenId> * nGram_in, int givenLength_in, int * givenCount_out);
+
+    /*******************
+    * Finds the occurances of an ngram of identifiers and of the context it begins with
+    * @param  nGram_in        identifiers of the ngram
+    * @param  length_in       number of identifiers in the ngram
+    * @param  givenLength_in  number of identifiers in the context
+    * @param  givenCount_out  location to store the occurances of the context
+    * @return number of occurances of the ngram in the dictionary
+    *******************/
+    int countIdsGiven(const TokenId * nGram_in, int length_in, int givenLength_in, int * givenCount_out);
+
+    /*******************
+    * Packs the counts into a trie and stores the probability of every ngram in it as the code of a bin
+    * of the natural log of the probability, with the bins of each length chosen from its probabilities
+    * @param  numBits_in     number of bits of each code, from 1 to QUANTIZED_MAX_BITS
+    * @param  probability_in function taking (ScorerState * state, int length) and returning the probability of
+    *                        the token stored just after the state's context, which holds the rest of the ngram
+    * @return 0  success
+    * @return -1 the counts could not be packed into a trie
+    *******************/
+    template <typename Function> int quantizeProbabilities(int numBits_in, Function probability_in);
+
+    /*******************
+    * Finds the quantized probability of a stored ngram
+    * @param  nGram_in    identifiers of the ngram
+    * @param  length_in   number of identifiers in the ngram
+    * @param  location_in location to store the natural log of the probability
+    * @return 1 the probability was found
+    * @return 0 the probabilities are not quantized or the ngram is not stored
+    *******************/
+    int quantizedProbability(const TokenId * nGram_in, int length_in, double * location_in);
+
+    /*******************
+    * Finds the identifier each of this document's tokens has in another document
+    * @param  document_in document to find the identifiers in
+    * @param  location_in location to store the identifiers, indexed by this document's identifiers
+    * @return 0 success
+    *******************/
+    int mapIds(Document * document_in, std::vector<TokenId> * location_in);
+
+  public:
+    /*******************
+    * Creates a new instance of Document finding all the ngrams 
+    * from size 1 to the specified number
+    * @param tokens_in    tokens to create the document from
+    * @param gramLenth_in longest nGrams to search for
+    *******************/
+    Document(std::vector<Type> * tokens_in, int gramLength_in);
+    /*******************
+    * Creates a new instance of Document finding all the ngrams 
+    * from a specified size to another specified size
+    * @param tokens_in    tokens to create the document from
+    * @param gramLenthLow_in  shortest nGrams to search for
+    * @param gramLenthHigh_in longest nGrams to search for
+    *******************/
+    Document(std::vector<Type> * tokens_in, int gramLengthLow_in, int gramLengthHigh_in);
+    /*******************
+    * Creates a new instance of Document finding all the ngrams 
+    * of the sizes specified in the inout vector
+    * @param tokens_in    tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    *******************/
+    Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in);
+    /*******************
+    * Creates a new instance of Document finding all the ngrams of the sizes specified in the
+    * input vector, counted on several threads. Later calls to readTokens use as many threads
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param numThreads_in  number of threads to count with
+    *******************/
+    Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in);
+    /*******************
+    * Creates a new instance of Document from tokens that have already been given identifiers,
+    * finding all the ngrams of the sizes specified in the inout vector
+    * @param lexicon_in     lexicon the identifiers were taken from
+    * @param tokens_in      identifiers of the tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    *******************/
+    Document(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in);
+    /*******************
+    * Creates a new instance of Document by counting ngrams of the sizes specified in
+    * the input vector as the tokens are read from a source
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param keepTokens_in  if this is >0 the tokens are also stored so more lengths can be read later
+    *******************/
+    Document(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in);
+    /*******************
+    * Creates a new instance of Document that counts the lengths longer than options_in->exactLength in
+    * count-min sketches of a fixed size. Counts of those lengths are estimates that are never too low and
+    * too high by at most the error bound of getSketchStats with its confidence. Only the heavy hitters
+    * are held in the tables, so forEachNgram and the methods built on it fail for those lengths
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in);
+    /*******************
+    * Creates a new instance of Document that counts the lengths longer than options_in->exactLength in
+    * count-min sketches as the tokens are read from a source, which is not kept
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    Document(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in);
+    /*******************
+    * Creates a new instance of Document that queries its counts directly from a mapped
+    * model file. The lexicon is read into memory, the ngrams are not, so the model file
+    * must stay open for as long as the document is used
+    * @param model_in model file to query the counts from
+    *******************/
+    Document(ModelFile * model_in);
+
+    //Default constructor and destructor
+    Document();
+    ~Document();
+
+    /*******************
+    * Reads tokens of the specified lengths from the document's tokens
+    * @param  lengths_in ngram lengths to be created from the tokens
+    * @return 0  success
+    * @return -1 the tokens were not kept when the document was streamed or were packed into a trie
+    *******************/
+    int readTokens(std::vector<int> * lengths_in);
+
+    /*******************
+    * Reads tokens from lengths 1 to the specified length from the document's tokens
+    * @param  length_in ngram lengths to be created from the tokens
+    * @return 0  success
+    * @return -1 the tokens were not kept when the document was streamed or were packed into a trie
+    *******************/
+    int readTokens(int length_in);
+
+    /*******************
+    * Packs the counts of every length into a trie where each ngram is stored as the node of
+    * its context plus its last token, and releases the tables. The counts of an ngram and of
+    * its context are then found in one descent. No new lengths or ngrams can be added afterwards
+    * @return 0  success
+    * @return -1 the lengths do not run from 1 to the longest length, the document was loaded from a model file or counts with sketches
+    *******************/
+    int buildTrie();
+
+    /*******************
+    * Packs the counts of the trie, building it first if it has not been. Counts of 1, which most
+    * ngrams have, take a single bit and the other counts of each length take as few bits as the
+    * largest of them needs. Counts are found the same way afterwards
+    * @return 0  success
+    * @return -1 the trie could not be built, as for buildTrie
+    *******************/
+    int packCounts();
+
+    /*******************
+    * Finds the number of bytes used by the counts of the document, in its tables or its trie,
+    * and by its context totals and quantized probabilities
+    * @return bytes used, not counting the lexicon or the tokens
+    *******************/
+    size_t memoryUsage();
+
+    /*******************
+    * Builds a bloom filter of the ngrams of every length read, which is checked before the counts so most
+    * ngrams that were never stored are ruled out without probing a table. Should be called once all of
+    * the ngrams have been read
+    * @param  falsePositiveRate_in chance of an ngram that was never stored being passed by a filter
+    * @param  numBytes_in          most bytes the filters may use together, 0 for no limit. When the rate
+    *                              needs more the filters shrink in proportion and pass more ngrams
+    * @return 0  success
+    * @return -1 the document counts with sketches, which hold ngrams a filter would rule out
+    *******************/
+    int buildFilters(double falsePositiveRate_in, size_t numBytes_in);
+
+    /*******************
+    * Finds how often the bloom filter of a length has been checked and what it decided
+    * @param  length_in   length of the ngrams the filter holds
+    * @param  location_in location to store the counters
+    * @return 0  success
+    * @return -1 there is no filter for the length
+    *******************/
+    int getFilterStats(int length_in, BloomStats * location_in);
+
+    /*******************
+    * Finds the size and error bound of the sketch of a length
+    * @param  length_in   length of the ngrams the sketch counts
+    * @param  location_in location to store the size and bound
+    * @return 0  success
+    * @return -1 the length is not counted with a sketch
+    *******************/
+    int getSketchStats(int length_in, SketchStats * location_in);
+
+    /*******************
+    * Finds the most frequent ngrams of a length held in its table. For a sketched length these are the
+    * heavy hitters, counted exactly on top of the estimate they had when they reached the heavy count
+    * @param  length_in     length of the ngrams
+    * @param  numResults_in most ngrams to find
+    * @param  location_in   location to store (ngram, count) pairs, most frequent first
+    * @return 0  success
+    * @return -1 the length has not been read
+    *******************/
+    int heavyHitters(int length_in, int numResults_in, std::vector<std::pair<std::vector<Type>, int>> * location_in);
+
+    /*******************
+    * Sorts the ngrams of every length read by a 64 bit fingerprint of their tokens. Once two documents
+    * both have them, numCommon and findCommon merge the two sorted lists instead of probing a table
+    * for every ngram. Fingerprints depend only on the tokens so documents with different lexicons
+    * can be compared, and ngrams with equal fingerprints are still checked token by token
+    * @return 0  success
+    * @return -1 a length is counted in a sketch, which can not list its ngrams
+    *******************/
+    int buildFingerprints();
+
+    /*******************
+    * Drops ngrams longer than 1 that barely change the probabilities of the document. The score of an
+    * ngram is the relative entropy lost by predicting its last token from one less token of context,
+    * c / numNgrams * log(P(token | context) / P(token | shorter context)), where c is the count of the ngram
+    * lowered by the absolute discount of its length so rare ngrams are not overrated. Ngrams that start or
+    * end a longer ngram that is kept are always kept so every context of a kept ngram is still counted.
+    * The scores assume a dropped ngram is predicted from the shorter context, as a backoff model reading
+    * these counts would. The models of this library do not back off, so they only prune by the cutoffs
+    * @param  cutoffs_in   ngrams with a count of at most the value at their length minus 1 are dropped, may be NULL
+    * @param  threshold_in ngrams scoring less are dropped, 0 to only use the cutoffs and the budget
+    * @param  numBytes_in  most bytes the tables may use together, 0 for no limit. The threshold is raised
+    *                      until the tables fit
+    * @param  location_in  location to store the sizes before and after, may be NULL
+    * @return 0  success
+    * @return -1 document was loaded from a model file, packed into a trie or counts with sketches and can not change
+    * @return -2 the lengths do not run from 1 to the longest length
+    *******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in);
+
+    /*******************
+    * Prunes the document and finds the perplexity of a model built on it over held out sentences
+    * before and after, so the cost of the bytes saved can be seen
+    * @param  cutoffs_in   ngrams with a count of at most the value at their length minus 1 are dropped, may be NULL
+    * @param  threshold_in ngrams scoring less are dropped, 0 to only use the cutoffs and the budget
+    * @param  numBytes_in  most bytes the tables may use together, 0 for no limit
+    * @param  model_in     model reading this document's counts, usually the document itself
+    * @param  length_in    length of ngrams the model scores with
+    * @param  heldOut_in   held out sentences to score
+    * @param  location_in  location to store the sizes and perplexities
+    * @return 0  success
+    * @return -1 document was loaded from a model file, packed into a trie or counts with sketches and can not change
+    * @return -2 the lengths do not run from 1 to the longest length
+    *******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in, int length_in,
+      std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in);
+
+    /*******************
+    * Caches the totals of the ngrams that follow every context, for each length whose ngrams one token
+    * longer have been read and are not counted with sketches. Reading tokens and pruning build them,
+    * adding an ngram drops them. countIdsGiven then finds the count of a context and whether anything
+    * follows it with one lookup, and skips probing for the ngram when nothing does
+    * @return 0 success
+    *******************/
+    int buildTotals();
+
+    /*******************
+    * Finds the totals of the ngrams that follow a context
+    * @param  context_in  identifiers of the context
+    * @param  length_in   number of identifiers in the context, 0 for the totals of single tokens
+    * @param  location_in location to store the totals, all 0 if the context never occurs and only the
+    *                     count set if it only occurs at the end of the document
+    * @return 0  success
+    * @return -1 the totals of contexts of this length were not built
+    *******************/
+    int findTotals(const TokenId * context_in, int length_in, ContextTotals * location_in);
+
+    /*******************
+    * Writes the document to a model file that can be mapped by Document(ModelFile *)
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written or the document counts with sketches
+    *******************/
+    int saveModel(std::string fileName_in);
+
+    /*******************
+    * Sets the number of threads used to count ngrams by later calls to readTokens. The first
+    * lengths are counted in parallel by constructing the document with a number of threads
+    * @param  numThreads_in number of threads to count with
+    * @return 0 success
+    *******************/
+    int setThreads(int numThreads_in);
+
+    /*******************
+    * Checks if grams of the specified length have been added to the dictionary
+    * @param  length_in the ngram length to check the dictionary for
+    * @return -1 invalid ngram length
+    * @return 0  ngrams of specified length have not been read
+    * @return 1  ngrams of specified length have been read
+    *******************/
+    int hasNgrams(int length_in);
+
+    /*******************
+    * Checks if grams of the specified length are counted in a sketch, which can not list them
+    * @param  length_in the ngram length to check
+    * @return -1 invalid ngram length
+    * @return 0  ngrams of specified length are counted exactly or have not been read
+    * @return 1  ngrams of specified length are counted in a sketch
+    *******************/
+    int isSketched(int length_in);
+
+    /*******************
+    * Returns the number of ngrams of a specified length in the document
+    * @param  length_in  length of ngrams to get count for
+    * @return number of ngrams in the document
+    *******************/
+    int numNgrams(int length_in);
+
+    /*******************
+    * Returns the number of disctict ngrams in the document
+    * @param  length_in  length of ngrams to get count for
+    * @return number of distinct ngrams in the document
+    *******************/
+    int numDistinctNgrams(int length_in);
+
+    /*******************
+    * Finds the occurances of an ngram in the document
+    * @param  nGram_in ngram to check for existace
+    * @return number of occurances of nGram in dictionary
+    *******************/
+    int countNgram(std::vector<Type> * nGram_in);
+
+    /*******************
+    * Finds the occurances of an ngram viewed in place, such as a piece of a sentence, without allocating
+    * for ngrams of up to NGRAM_VIEW_LENGTH tokens
+    * @param  nGram_in  first token of the ngram
+    * @param  length_in number of tokens in the ngram
+    * @return number of occurances of nGram in dictionary
+    *******************/
+    int countNgram(const Type * nGram_in, int length_in);
+
+    /*******************
+    * Checks if an nGram occurs in this document
+    * @param  nGram_in ngram to check for existace
+    * @return 0 nGram is not in database
+    * @return 1 nGram is in database
+    *******************/
+    int hasNgram(std::vector<Type> * nGram_in);
+
+    /*******************
+    * Checks if an nGram viewed in place occurs in this document
+    * @param  nGram_in  first token of the ngram
+    * @param  length_in number of tokens in the ngram
+    * @return 0 nGram is not in database
+    * @return 1 nGram is in database
+    *******************/
+    int hasNgram(const Type * nGram_in, int length_in);
+
+    /*******************
+    * Adds an nGram to the dictionary
+    * @param nGram_in ngram to add to the database
+    * @return 0  success
+    * @return -1 document was loaded from a model file or packed into a trie and can not change
+    *******************/
+    int addNgram(std::vector<Type> * nGram_in);
+
+    /*******************
+    * Finds the number of ngrams in this document that are also in the specified document
+    * @param  length_in   ngram length to compare
+    * @param  document_in document to compare to
+    * @param  location_in location to store the number of common ngrams to both documents
+    * @return 0  success
+    * @return -1 the length is counted in a sketch in either document, which can not list its ngrams
+    ******************/
+    int numCommon(int length_in, Document * document_in, int * location_in);
+
+    /*******************
+    * Shows the ngrams of a specified length in this document that are also in a specifeid document
+    * @param  length_in   ngram length to compare
+    * @param  document_in document to compare to
+    * @param  result_in   location to store the common ngrams
+    * @return 0  success
+    * @return -1 the length is counted in a sketch in either document, which can not list its ngrams
+    ******************/
+    int findCommon(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in);
+
+    /*******************
+    * Finds the number of ngrams every pair of documents shares, splitting the pairs between threads.
+    * Documents without fingerprints of the length have them built first
+    * @param  length_in    ngram length to compare, every document has to have read it
+    * @param  documents_in documents to compare
+    * @param  numThreads_in number of threads to compare on
+    * @param  location_in  location to store the matrix, the diagonal holds the distinct ngrams of each document
+    * @return 0  success
+    * @return -1 a document has not read the length or counts it in a sketch
+    ******************/
+    static int overlapMatrix(int length_in, std::vector<Document*> * documents_in, int numThreads_in, std::vector<std::vector<int>> * location_in);
+
+    /*******************
+    * Computes the MinHash signature of the set of ngrams of a length in this document. Tokens are hashed
+    * by value so signatures of documents with different lexicons, or of sentences, can be compared
+    * @param  length_in   ngram length to find the signature of
+    * @param  hasher_in   hasher making the signature
+    * @param  location_in location to store the signature
+    * @return 0  success
+    * @return -1 the length is not stored in this document or is counted in a sketch
+    ******************/
+    int signature(int length_in, MinHasher<Type> * hasher_in, std::vector<unsigned int> * location_in);
+
+    /*******************
+    * Finds the lexicon mapping this document's tokens to their identifiers
+    * @return the lexicon of the document
+    ******************/
+    Lexicon<Type> * getLexicon();
+
+    /*******************
+    * Finds the number of unique ngram lengths stored in this document
+    * @return number of ngram lengths on th document
+    ******************/
+    int numLengths();
+
+    /******************
+    * Checks if the document contains the specified sentence
+    * @param  ngramLength_in length of ngrams to check
+    * @param  sentence_in    sentence to check the document for
+    * @return 0 sentence is not in document
+    * @return 1 sentence is in document
+    ******************/
+    int hasSentence(int ngramLength_in, std::vector<Type> * sentence_in);
+
+    /******************
+    * Checks if the document contains a sentence viewed in place. Each token is looked up once
+    * as it enters a window of the last tokens, which does not allocate for lengths of up to NGRAM_VIEW_LENGTH
+    * @param  ngramLength_in length of ngrams to check
+    * @param  sentence_in    first token of the sentence
+    * @param  length_in      number of tokens in the sentence
+    * @return 0 sentence is not in document
+    * @return 1 sentence is in document
+    ******************/
+    int hasSentence(int ngramLength_in, const Type * sentence_in, int length_in);
+  };
+
+};
+
 #endif
\ No newline at end of file
@@ -17,7 +17,7 @@ namespace nlp {
       lengths.push_back(lengthIterator);
     }
 
-    init_object(tokens_in, &lengths);
+    init_object(tokens_in, &lengths, NULL, 1);
   }
 
   //Creates a new instance of Document finding all the ngrams from a specified size to another specified size
@@ -30,28 +30,311 @@ namespace nlp {
       lengths.push_back(lengthIterator);
     }
 
-    init_object(tokens_in, &lengths);
+    init_object(tokens_in, &lengths, NULL, 1);
   }
 
   //Creates a new instance of Document finding all the ngrams of the sizes specified in the input vector
   template <class Type> Document<Type>::Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in) {
-    init_object(tokens_in, gramLengths_in);
+    init_object(tokens_in, gramLengths_in, NULL, 1);
+  }
+
+  //Creates a new instance of Document finding all the ngrams of the sizes specified in the input vector on several threads
+  template <class Type> Document<Type>::Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in) {
+    init_object(tokens_in, gramLengths_in, NULL, numThreads_in);
+  }
+
+  //Creates a new instance of Document from tokens that have already been given identifiers
+  template <class Type> Document<Type>::Document(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in) {
+    lexicon = *lexicon_in;
+    tokens = *tokens_in;
+    init_counts(gramLengths_in, NULL, 1);
+  }
+
+  //Creates a new instance of Document by counting ngrams as the tokens are read from a source
+  template <class Type> Document<Type>::Document(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in) {
+    init_stream(source_in, gramLengths_in, keepTokens_in, NULL);
+  }
+
+  //Creates a new instance of Document that counts the longer lengths in count-min sketches
+  template <class Type> Document<Type>::Document(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in) {
+    init_object(tokens_in, gramLengths_in, options_in, 1);
+  }
+
+  //Creates a new instance of Document that counts the longer lengths in count-min sketches as the tokens are read from a source
+  template <class Type> Document<Type>::Document(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in) {
+    init_stream(source_in, gramLengths_in, 0, options_in);
+  }
+
+  //Creates a new instance of Document that queries its counts directly from a mapped model file
+  template <class Type> Document<Type>::Document(ModelFile * model_in) {
+    init_model(model_in);
   }
 
   //Initilizes the values of the object
-  template <class Type> int Document<Type>::init_object(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in) {
+  template <class Type> int Document<Type>::init_object(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in, int numThreads_in) {
+    //Save the identifiers of the input tokens to the document
+    lexicon.addTokens(tokens_in, &tokens);
+    return init_counts(gramLengths_in, options_in, numThreads_in);
+  }
+
+  //Initilizes the values of the object once its token identifiers have been stored
+  template <class Type> int Document<Type>::init_counts(std::vector<int> * gramLengths_in, SketchOptions * options_in, int numThreads_in) {
+    //Sketched documents still count on one thread, readTokens checks for them
+    setThreads(numThreads_in);
+    sketchOptions = options_in != NULL ? *options_in : SketchOptions();
     //Sort the ngram sizes
     std::sort(gramLengths_in->begin(), gramLengths_in->end());
     //Save the number of tokens in this document
-    numTokens = tokens_in->size();
-    //Save the input tokens to the document
-    tokens = *tokens_in;
+    numTokens = tokens.size();
 
     readTokens(gramLengths_in);
     
     return 0;
   }
 
+  //Initilizes the values of the object by counting ngrams as tokens are read from a source
+  template <class Type> int Document<Type>::init_stream(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, SketchOptions * options_in) {
+    std::vector<int> lengths;
+    std::vector<NgramTable<int>*> tables;
+    std::vector<TokenId> window;
+    int filled;
+    int numStarts;
+
+    numThreads = 1;
+    sketchOptions = options_in != NULL ? *options_in : SketchOptions();
+    numTokens = 0;
+    addLengths(gramLengths_in, &lengths, &tables);
+    //Without any lengths to count the tokens only need to be counted
+    if (lengths.empty()) {
+      lengths.push_back(1);
+      tables.push_back(NULL);
+    }
+
+    //The window holds a batch of tokens plus the tokens carried over from the last batch
+    window.resize(STREAM_BUFFER_LENGTH + lengths.back() - 1);
+    filled = 0;
+    while (source_in->nextId(&lexicon, &window[filled])) {
+      if (keepTokens_in > 0) {
+        tokens.push_back(window[filled]);
+      }
+      ++numTokens;
+      ++filled;
+      if (filled < (int) window.size()) {
+        continue;
+      }
+      //Count every ngram that fits in the window
+      numStarts = filled - (lengths.back() - 1);
+      if (tables[0] != NULL) {
+        countNgrams(window.data(), numStarts, filled, &lengths, &tables);
+      }
+      //Tokens that start ngrams which do not fit yet are carried over to the next batch
+      std::copy(window.begin() + numStarts, window.end(), window.begin());
+      filled -= numStarts;
+    }
+    //Every token left starts the ngrams that fit before the end of the source
+    if (tables[0] != NULL) {
+      countNgrams(window.data(), filled, filled, &lengths, &tables);
+    }
+    buildTotals();
+
+    return 0;
+  }
+
+  //Initilizes the values of the object from a mapped model file
+  template <class Type> int Document<Type>::init_model(ModelFile * model_in) {
+    const ModelHeader * header;
+    const char * bytes;
+    int wordIterator;
+    int orderIterator;
+    int numBytes;
+    Type token;
+
+    header = model_in->getHeader();
+    numThreads = 1;
+    sketchOptions = SketchOptions();
+    //The tokens themselves are not stored so no new lengths can be read
+    numTokens = header->numTokens;
+
+    //Identifiers are given in order so they match the identifiers in the file
+    for (wordIterator = 0; wordIterator < header->numWords; ++wordIterator) {
+      bytes = model_in->getWord(wordIterator, &numBytes);
+      bytesToToken(bytes, numBytes, &token);
+      lexicon.addToken(&token);
+    }
+
+    for (orderIterator = 0; orderIterator < header->numOrders; ++orderIterator) {
+      frozen.push_back(model_in->getOrder(orderIterator));
+      ngramLengths.push_back(frozen.back().length);
+      //Tables are kept empty so each length has the same index in both lists
+      dictionary.push_back(NgramTable<int>(frozen.back().length));
+    }
+
+    return 0;
+  }
+
+  //Writes the document to a model file
+  template <class Type> int Document<Type>::saveModel(std::string fileName_in) {
+    ModelHeader header;
+    std::vector<std::vector<FrequencyPair>> frequencies;
+    std::vector<std::vector<ProbabilityPair>> probabilities;
+
+    header.kind = MODEL_KIND_DOCUMENT;
+    header.delta = 0;
+    header.threshold = 0;
+    header.vocabulary = 0;
+
+    return writeModel(fileName_in, &header, &frequencies, &probabilities);
+  }
+
+  //Writes the lexicon and the counts of every ngram length to a model file
+  template <class Type> int Document<Type>::writeModel(std::string fileName_in, ModelHeader * header_in, std::vector<std::vector<FrequencyPair>> * frequencies_in,
+    std::vector<std::vector<ProbabilityPair>> * probabilities_in) {
+    std::vector<std::string> words;
+    std::vector<SortedNgrams> orders;
+    std::vector<std::vector<TokenId>> keys;
+    std::vector<std::vector<int>> counts;
+    std::vector<int> entries;
+    int wordIterator;
+    int lengthIterator;
+    int length;
+
+    //The tables of sketched lengths only hold the heavy hitters
+    if (! sketches.empty()) {
+      return -1;
+    }
+    header_in->numTokens = numTokens;
+    words.resize(lexicon.size());
+    for (wordIterator = 0; wordIterator < lexicon.size(); ++wordIterator) {
+      tokenToBytes(lexicon.getToken(wordIterator), &words[wordIterator]);
+    }
+
+    //A document loaded from a model file already has its ngrams sorted
+    if (! frozen.empty()) {
+      orders = frozen;
+      return ModelFile::write(fileName_in, header_in, &words, &orders, frequencies_in, probabilities_in);
+    }
+
+    keys.resize(dictionary.size());
+    counts.resize(dictionary.size());
+    for (lengthIterator = 0; lengthIterator < (int) dictionary.size(); ++lengthIterator) {
+      NgramTable<int> & table = dictionary[lengthIterator];
+      std::vector<const TokenId *> sorted;
+      length = table.getLength();
+
+      if (trie.getLength() > 0) {
+        //A trie already visits its ngrams in sorted order
+        forEachNgram(length, [&](const TokenId * key_in, int count_in) {
+          keys[lengthIterator].insert(keys[lengthIterator].end(), key_in, key_in + length);
+          counts[lengthIterator].push_back(count_in);
+        });
+      } else {
+        //Sort the keys of the table so they can be found by binary search
+        for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+          sorted.push_back(iterator.key());
+        }
+        std::sort(sorted.begin(), sorted.end(), [length](const TokenId * first, const TokenId * second) {
+          return std::lexicographical_compare(first, first + length, second, second + length);
+        });
+        keys[lengthIterator].reserve(sorted.size() * length);
+        for (auto key : sorted) {
+          keys[lengthIterator].insert(keys[lengthIterator].end(), key, key + length);
+          counts[lengthIterator].push_back(*table.find(key));
+        }
+      }
+
+      SortedNgrams order;
+      order.length = length;
+      order.numEntries = counts[lengthIterator].size();
+      order.keys = keys[lengthIterator].data();
+      order.counts = counts[lengthIterator].data();
+      orders.push_back(order);
+    }
+
+    return ModelFile::write(fileName_in, header_in, &words, &orders, frequencies_in, probabilities_in);
+  }
+
+  //Writes every stored ngram to a file in the ARPA format
+  template <class Type> template <typename Function> int Document<Type>::writeArpa(std::string fileName_in, Function probability_in) {
+    std::vector<int> lengths;
+    std::vector<Type> ngram;
+    std::string bytes;
+    int lengthIterator;
+    int tokenIterator;
+    int result;
+    double probability;
+    FILE * file;
+
+    //ARPA files need every length up to the longest one
+    lengths = ngramLengths;
+    std::sort(lengths.begin(), lengths.end());
+    for (lengthIterator = 0; lengthIterator < (int) lengths.size(); ++lengthIterator) {
+      if (lengths[lengthIterator] != lengthIterator + 1) {
+        return -2;
+      }
+    }
+
+    file = fopen(fileName_in.c_str(), "w");
+    if (file == NULL) {
+      return -1;
+    }
+
+    fprintf(file, "\n\\data\\\n");
+    for (lengthIterator = 1; lengthIterator <= (int) lengths.size(); ++lengthIterator) {
+      fprintf(file, "ngram %d=%d\n", lengthIterator, numDistinctNgrams(lengthIterator));
+    }
+
+    for (lengthIterator = 1; lengthIterator <= (int) lengths.size(); ++lengthIterator) {
+      fprintf(file, "\n\\%d-grams:\n", lengthIterator);
+      result = forEachNgram(lengthIterator, [&](const TokenId * key_in, int) {
+        lexicon.getTokens(key_in, lengthIterator, &ngram);
+        probability = probability_in(&ngram);
+        //Impossible ngrams are given the conventional stand in for log10(0)
+        fprintf(file, "%.7g", probability > 0 ? log10(probability) : ARPA_LOG_ZERO);
+        for (tokenIterator = 0; tokenIterator < lengthIterator; ++tokenIterator) {
+          tokenToBytes(&ngram[tokenIterator], &bytes);
+          fputc(tokenIterator == 0 ? '\t' : ' ', file);
+          fwrite(bytes.data(), 1, bytes.size(), file);
+        }
+        fputc('\n', file);
+      });
+      if (result) {
+        fclose(file);
+        return -1;
+      }
+    }
+    fprintf(file, "\n\\end\\\n");
+
+    return fclose(file) == 0 ? 0 : -1;
+  }
+
+  //Calls a function with the identifiers and count of every ngram of a length
+  template <class Type> template <typename Function> int Document<Type>::forEachNgram(int length_in, Function function_in) {
+    int index;
+    int entryIterator;
+
+    index = getIndex(length_in);
+    //A sketch keeps no list of its ngrams, and its table only holds the heavy hitters
+    if (index < (int) sketches.size() && sketches[index].size() > 0) {
+      return -1;
+    }
+    if (! frozen.empty()) {
+      for (entryIterator = 0; entryIterator < frozen[index].numEntries; ++entryIterator) {
+        function_in(frozen[index].keys + (size_t) entryIterator * length_in, frozen[index].counts[entryIterator]);
+      }
+      return 0;
+    }
+
+    if (trie.getLength() > 0) {
+      return trie.forEach(length_in, function_in);
+    }
+
+    for (auto iterator = dictionary[index].begin(); iterator != dictionary[index].end(); ++iterator) {
+      function_in(iterator.key(), iterator.value());
+    }
+
+    return 0;
+  }
+
   //Reads tokens from lengths 1 to the specified length from the document's tokens
   template <class Type> int Document<Type>::readTokens(int length_in) {
     std::vector<int> lengths;
@@ -61,19 +344,51 @@ namespace nlp {
       lengths.push_back(lengthIterator);
     }
 
-    readTokens(&lengths);
-
-    return 0;
+    return readTokens(&lengths);
   }
 
   //Reads tokens of the specified lengths from the document's tokens
   template <class Type> int Document<Type>::readTokens(std::vector<int> * lengths_in) {
-    int lengthIterator;
     std::vector<int> lengths;
-    int tokenIterator;
-    int currentToken;
-    int dictionaryIndex;
-    int numGramSizes;
+    std::vector<NgramTable<int>*> tables;
+
+    int lengthIterator;
+
+    //A streamed document may not have kept the tokens it needs to read new lengths
+    if ((int) tokens.size() != numTokens || trie.getLength() > 0) {
+      for (lengthIterator = 0; lengthIterator < (int) lengths_in->size(); ++lengthIterator) {
+        if (! hasNgrams((*lengths_in)[lengthIterator])) {
+          return -1;
+        }
+      }
+      return 0;
+    }
+
+    addLengths(lengths_in, &lengths, &tables);
+
+    //Add ngrams to dictionary
+    if (lengths.empty()) {
+      return 0;
+    }
+    //The filters and fingerprints no longer cover every length
+    filters.clear();
+    fingerprints.clear();
+    //Threads would share the counters of a sketch so sketched documents count on one thread
+    if (numThreads > 1 && sketches.empty()) {
+      countNgramsParallel(&lengths, &tables);
+    } else {
+      countNgrams(tokens.data(), numTokens, numTokens, &lengths, &tables);
+    }
+    //New lengths give new contexts their totals
+    buildTotals();
+
+    return 0;
+  }
+
+  //Adds a table to the dictionary for each length that has not been read
+  template <class Type> int Document<Type>::addLengths(std::vector<int> * lengths_in, std::vector<int> * lengths_out, std::vector<NgramTable<int>*> * tables_out) {
+    int lengthIterator;
+    std::vector<int> & lengths = *lengths_out;
 
     lengths = *lengths_in;
     //Check if each length is alread in the dictionary
@@ -85,42 +400,147 @@ namespace nlp {
       }
       ++lengthIterator;
     }
+    //The window grows one token at a time so the lengths must be in order
+    std::sort(lengths.begin(), lengths.end());
 
-    numGramSizes = lengths.size();
-    for (lengthIterator = 0; lengthIterator < numGramSizes; ++lengthIterator) {
-      //Create a new nashmap and add it to the dictionary
-      std::unordered_map<std::vector<Type>, int> newMap;
-      dictionary.push_back(newMap);
-      //Add the ngram length of this hashmap to the list
+    for (lengthIterator = 0; lengthIterator < (int) lengths.size(); ++lengthIterator) {
+      //Create a new table and add it to the dictionary
+      dictionary.push_back(NgramTable<int>(lengths[lengthIterator]));
+      //Add the ngram length of this table to the list
       ngramLengths.push_back(lengths[lengthIterator]);
     }
-
-    //Add ngrams to dictionary
-    for (tokenIterator = 0; tokenIterator < numTokens; ++tokenIterator) {
-      //Create a new nGram
-      currentToken = 0;
-      std::vector<Type> newGram;
-      for (lengthIterator = 0; lengthIterator < numGramSizes; ++lengthIterator) {
-        //Check to make sure we are not going out of bounds
-        if (tokenIterator + lengths[lengthIterator] > numTokens) {
-          break;
+    //Find the new tables once they have all been added
+    for (lengthIterator = 0; lengthIterator < (int) lengths.size(); ++lengthIterator) {
+      tables_out->push_back(&dictionary[getIndex(lengths[lengthIterator])]);
+    }
+    //Lengths longer than the exact ones get a sketch, the others keep an empty one
+    if (sketchOptions.numBytes > 0) {
+      sketches.resize(dictionary.size());
+      for (lengthIterator = 0; lengthIterator < (int) lengths.size(); ++lengthIterator) {
+        if (lengths[lengthIterator] > sketchOptions.exactLength) {
+          sketches[getIndex(lengths[lengthIterator])].reset(sketchOptions.numBytes, sketchOptions.depth > 0 ? sketchOptions.depth : SKETCH_DEPTH);
         }
-        //Append tokens to the ngram until it matches the specified length
-        while (currentToken < lengths[lengthIterator]) {
-          newGram.push_back(tokens[tokenIterator + currentToken++]);
+      }
+    }
+
+    return 0;
+  }
+
+  //Counts the ngrams starting at each of a run of token identifiers
+  template <class Type> int Document<Type>::countNgrams(const TokenId * tokens_in, int numStarts_in, int numTokens_in, std::vector<int> * lengths_in, std::vector<NgramTable<int>*> * tables_in) {
+    std::vector<CountMinSketch*> lengthSketches;
+    int tokenIterator;
+    int windowIterator;
+    int windowLength;
+    int lengthIterator;
+    int index;
+    NgramHash hash;
+
+    //The sketch of each length, NULL for the lengths counted exactly
+    for (lengthIterator = 0; lengthIterator < (int) lengths_in->size(); ++lengthIterator) {
+      index = getIndex((*lengths_in)[lengthIterator]);
+      lengthSketches.push_back(index < (int) sketches.size() && sketches[index].size() > 0 ? &sketches[index] : NULL);
+    }
+
+    for (tokenIterator = 0; tokenIterator < numStarts_in; ++tokenIterator) {
+      //The window can not extend past the last token
+      windowLength = std::min(lengths_in->back(), numTokens_in - tokenIterator);
+      hash = NGRAM_HASH_SEED;
+      lengthIterator = 0;
+      for (windowIterator = 0; windowIterator < windowLength; ++windowIterator) {
+        //Each hash code extends the hash code of the ngram one shorter
+        hash = NgramTable<int>::hashStep(hash, tokens_in[tokenIterator + windowIterator]);
+        if (windowIterator + 1 != (*lengths_in)[lengthIterator]) {
+          continue;
         }
-        dictionaryIndex = getIndex(lengths[lengthIterator]);
-        //Push the current ngram to the correct gram length matcher
-        if (dictionary[dictionaryIndex].count(newGram) == 0) {
-          //If nGram is not in dictionary add it as count 1
-          dictionary[dictionaryIndex][newGram] = 1;
+        //Counting the ngram is a single probe, new ngrams start at a count of 0
+        if (lengthSketches[lengthIterator] != NULL) {
+          countSketched((*tables_in)[lengthIterator], lengthSketches[lengthIterator], &tokens_in[tokenIterator], NgramTable<int>::hashFinish(hash));
         } else {
-          //If ngram is in dictionary increase count
-          dictionary[dictionaryIndex][newGram] = dictionary[dictionaryIndex][newGram] + 1;
+          *(*tables_in)[lengthIterator]->insert(&tokens_in[tokenIterator], NgramTable<int>::hashFinish(hash)) += 1;
         }
+        ++lengthIterator;
+      }
+    }
+
+    return 0;
+  }
+
+  //Counts the ngrams of the whole document across multiple threads
+  template <class Type> int Document<Type>::countNgramsParallel(std::vector<int> * lengths_in, std::vector<NgramTable<int>*> * tables_in) {
+    std::vector<std::vector<NgramTable<int>>> localTables;
+    std::vector<std::vector<NgramTable<int>*>> localPointers;
+    std::vector<std::thread> threads;
+    int threadIterator;
+    int lengthIterator;
+    int chunkLength;
+    int chunkStart;
+
+    //Every thread counts the ngrams starting in its own chunk of the tokens
+    chunkLength = (numTokens + numThreads - 1) / numThreads;
+    localTables.resize(numThreads);
+    localPointers.resize(numThreads);
+    for (threadIterator = 0; threadIterator < numThreads; ++threadIterator) {
+      for (lengthIterator = 0; lengthIterator < (int) lengths_in->size(); ++lengthIterator) {
+        localTables[threadIterator].push_back(NgramTable<int>((*lengths_in)[lengthIterator]));
+      }
+      for (lengthIterator = 0; lengthIterator < (int) lengths_in->size(); ++lengthIterator) {
+        localPointers[threadIterator].push_back(&localTables[threadIterator][lengthIterator]);
       }
+      chunkStart = std::min(threadIterator * chunkLength, numTokens);
+      //The ngrams starting at the end of a chunk read into the start of the next one
+      threads.push_back(std::thread(&Document<Type>::countNgrams, this, tokens.data() + chunkStart,
+        std::min(chunkLength, numTokens - chunkStart), numTokens - chunkStart, lengths_in, &localPointers[threadIterator]));
     }
+    for (threadIterator = 0; threadIterator < numThreads; ++threadIterator) {
+      threads[threadIterator].join();
+    }
+
+    //Each length is merged on its own thread since the lengths share no tables
+    threads.clear();
+    for (lengthIterator = 0; lengthIterator < (int) lengths_in->size(); ++lengthIterator) {
+      threads.push_back(std::thread([&localTables, tables_in, lengthIterator]() {
+        for (auto & local : localTables) {
+          //The first table can be taken as it is rather than merged
+          if ((*tables_in)[lengthIterator]->size() == 0) {
+            std::swap(*(*tables_in)[lengthIterator], local[lengthIterator]);
+            continue;
+          }
+          (*tables_in)[lengthIterator]->merge(&local[lengthIterator]);
+          //Release the thread's table as soon as it has been merged
+          local[lengthIterator] = NgramTable<int>();
+        }
+      }));
+    }
+    for (lengthIterator = 0; lengthIterator < (int) threads.size(); ++lengthIterator) {
+      threads[lengthIterator].join();
+    }
+
+    return 0;
+  }
+
+  //Counts one occurance of an ngram of a sketched length
+  template <class Type> int Document<Type>::countSketched(NgramTable<int> * table_in, CountMinSketch * sketch_in, const TokenId * key_in, NgramHash hash_in) {
+    unsigned int estimate;
+    int * exact;
+
+    exact = table_in->find(key_in, hash_in);
+    if (exact != NULL) {
+      *exact += 1;
+      return 0;
+    }
+    //A heavy hitter starts from its estimate, which is no more than the error bound too high
+    estimate = sketch_in->add(hash_in);
+    if (sketchOptions.heavyCount > 0 && estimate >= (unsigned int) sketchOptions.heavyCount && table_in->size() < sketchOptions.maxHeavy) {
+      *table_in->insert(key_in, hash_in) = estimate;
+    }
+
+    return 0;
+  }
 
+  //Sets the number of threads used to count ngrams by later calls to readTokens
+  template <class Type> int Document<Type>::setThreads(int numThreads_in) {
+    numThreads = numThreads_in < 1 ? 1 : numThreads_in;
     return 0;
   }
 
@@ -134,43 +554,710 @@ namespace nlp {
     int index;
 
     index = getIndex(length_in);
+    if (! frozen.empty()) {
+      return frozen[index].numEntries;
+    }
+    if (trie.getLength() > 0) {
+      return trie.size(length_in);
+    }
+    //Heavy hitters were in the sketch before they moved to the table so the sketch's estimate covers them
+    if (index < (int) sketches.size() && sketches[index].size() > 0) {
+      return std::max((size_t) dictionary[index].size(), sketches[index].numDistinct());
+    }
     return dictionary[index].size();
   }
 
   //Finds the occurances of an ngram in the document
   template <class Type> int Document<Type>::countNgram(std::vector<Type> * nGram_in) {
+    return countNgram(nGram_in->data(), nGram_in->size());
+  }
+
+  //Finds the occurances of an ngram viewed in place
+  template <class Type> int Document<Type>::countNgram(const Type * nGram_in, int length_in) {
+    TokenId ids[NGRAM_VIEW_LENGTH];
+    std::vector<TokenId> longIds;
+    TokenId * location;
+
+    //Lengths that were never read can not occur, which also keeps most lookups on the stack
+    if (length_in < 1 || hasNgrams(length_in) != 1) {
+      return 0;
+    }
+    if (length_in > NGRAM_VIEW_LENGTH) {
+      longIds.resize(length_in);
+      location = longIds.data();
+    } else {
+      location = ids;
+    }
+
+    //If a token was never seen the ngram can not occur
+    if (lexicon.findTokens(nGram_in, length_in, location)) {
+      return 0;
+    }
+
+    return countIds(location, length_in);
+  }
+
+  //Finds the occurances of an ngram of token identifiers in the document
+  template <class Type> int Document<Type>::countIds(std::vector<TokenId> * nGram_in) {
+    return countIds(nGram_in->data(), nGram_in->size());
+  }
+
+  //Finds the occurances of the first identifiers of an ngram in the document
+  template <class Type> int Document<Type>::countIds(const TokenId * nGram_in, int length_in) {
+    BloomFilter * filter;
+    NgramHash hash;
+    int * result;
     int index;
+    int node;
+
+    //Every position in the document is an occurance of the empty ngram
+    if (length_in == 0) {
+      return numTokens;
+    }
+    index = getIndex(length_in);
+    //Ngrams of lengths that have not been read never occur
+    if (index == (int) dictionary.size()) {
+      return 0;
+    }
+    //Most ngrams that were never stored are ruled out without probing the table
+    filter = index < (int) filters.size() && filters[index].size() > 0 ? &filters[index] : NULL;
+    hash = 0;
+    if (filter != NULL) {
+      hash = NgramTable<int>::hashKey(nGram_in, length_in);
+      if (! filter->contains(hash)) {
+        return 0;
+      }
+    }
+    //A document loaded from a model file searches the file instead of its tables
+    if (! frozen.empty()) {
+      const int * stored = frozen[index].find(nGram_in);
+      if (stored == NULL && filter != NULL) {
+        filter->recordFalsePositive();
+      }
+      return stored == NULL ? 0 : *stored;
+    }
+    //A trie may have packed its counts so they are read from the node rather than through a pointer
+    if (trie.getLength() > 0) {
+      node = trie.find(nGram_in, length_in);
+      if (node < 0 && filter != NULL) {
+        filter->recordFalsePositive();
+      }
+      return node < 0 ? 0 : trie.getValue(length_in, node);
+    }
+    //The table reuses the hash code the filter was checked with
+    result = filter != NULL ? dictionary[index].find(nGram_in, hash) : dictionary[index].find(nGram_in);
+    if (result == NULL && filter != NULL) {
+      filter->recordFalsePositive();
+    }
+    //Ngrams that are not heavy hitters of a sketched length are estimated by its sketch
+    if (result == NULL && index < (int) sketches.size() && sketches[index].size() > 0) {
+      return sketches[index].estimate(NgramTable<int>::hashKey(nGram_in, length_in));
+    }
+
+    return result == NULL ? 0 : *result;
+  }
+
+  //Finds the occurances of an ngram of identifiers and of the context it begins with
+  template <class Type> int Document<Type>::countIdsGiven(std::vector<TokenId> * nGram_in, int givenLength_in, int * givenCount_out) {
+    return countIdsGiven(nGram_in->data(), nGram_in->size(), givenLength_in, givenCount_out);
+  }
+
+  //Finds the occurances of an ngram of identifiers and of the context it begins with
+  template <class Type> int Document<Type>::countIdsGiven(const TokenId * nGram_in, int length_in, int givenLength_in, int * givenCount_out) {
+    ContextTotals * contextTotals;
+    int counts[SCORER_MAX_LENGTH];
+
+    //One descent of the trie finds the count of every beginning of the ngram, the context among them
+    if (givenLength_in > 0 && givenLength_in < length_in && length_in <= trie.getLength() && length_in <= SCORER_MAX_LENGTH) {
+      trie.descend(nGram_in, length_in, counts);
+      *givenCount_out = counts[givenLength_in - 1];
+      return counts[length_in - 1];
+    }
+    //The totals of the context hold its count, and a context without totals begins no ngram
+    if (givenLength_in > 0 && givenLength_in == length_in - 1 && givenLength_in <= (int) totals.size()) {
+      contextTotals = totals[givenLength_in - 1].find(nGram_in);
+      if (contextTotals == NULL) {
+        *givenCount_out = countIds(nGram_in, givenLength_in);
+        return 0;
+      }
+      *givenCount_out = contextTotals->count;
+      return countIds(nGram_in, length_in);
+    }
+    *givenCount_out = countIds(nGram_in, givenLength_in);
+
+    return countIds(nGram_in, length_in);
+  }
+
+  //Packs the counts into a trie and stores the probability of every ngram in it as the code of a bin
+  template <class Type> template <typename Function> int Document<Type>::quantizeProbabilities(int numBits_in, Function probability_in) {
+    std::vector<std::vector<float>> logProbabilities;
+    ScorerState state;
+    int lengthIterator;
+
+    if (packCounts()) {
+      return -1;
+    }
+
+    //Every probability is found before any are stored since the model may read the stored ones.
+    //States hold at most SCORER_MAX_LENGTH tokens so no longer ngram is ever scored
+    quantized.clear();
+    logProbabilities.resize(std::min(trie.getLength(), SCORER_MAX_LENGTH));
+    for (lengthIterator = 1; lengthIterator <= (int) logProbabilities.size(); ++lengthIterator) {
+      std::vector<float> & current = logProbabilities[lengthIterator - 1];
+      int position;
+
+      //Nodes of length 1 are indexed by identifier, those never stored keep a value no lookup reads
+      current.assign(lengthIterator == 1 ? lexicon.size() : trie.size(lengthIterator), 0);
+      position = 0;
+      trie.forEach(lengthIterator, [&](const TokenId * key_in, int) {
+        //The state holds the ngram as the context and the token after it
+        resetState(&state);
+        std::copy(key_in, key_in + lengthIterator, state.context);
+        state.contextLength = lengthIterator - 1;
+        current[lengthIterator == 1 ? key_in[0] : position] = (float) log(probability_in(&state, lengthIterator));
+        ++position;
+      });
+    }
+    quantized.resize(logProbabilities.size());
+    for (lengthIterator = 0; lengthIterator < (int) logProbabilities.size(); ++lengthIterator) {
+      quantized[lengthIterator].assign(&logProbabilities[lengthIterator], numBits_in);
+    }
+
+    return 0;
+  }
+
+  //Finds the quantized probability of a stored ngram
+  template <class Type> int Document<Type>::quantizedProbability(const TokenId * nGram_in, int length_in, double * location_in) {
+    int node;
 
-    //If the ngram does not occur we can return 0 right away
-    if (! hasNgram(nGram_in)) {
+    if (length_in < 1 || length_in > (int) quantized.size()) {
+      return 0;
+    }
+    node = trie.find(nGram_in, length_in);
+    if (node < 0) {
       return 0;
     }
+    *location_in = quantized[length_in - 1].get(node);
 
-    index = getIndex(nGram_in->size());
-    return dictionary[index][*nGram_in];
+    return 1;
+  }
+
+  //Caches the totals of the ngrams that follow every context
+  template <class Type> int Document<Type>::buildTotals() {
+    int length;
+
+    totals.clear();
+    //The tables of sketched lengths only hold the heavy hitters, so their contexts get no totals
+    for (length = 1; hasNgrams(length) == 1 && hasNgrams(length + 1) == 1 && (getIndex(length + 1) >= (int) sketches.size() || sketches[getIndex(length + 1)].size() == 0); ++length) {
+      totals.push_back(NgramTable<ContextTotals>(length));
+      NgramTable<ContextTotals> & table = totals.back();
+      table.reserve(numDistinctNgrams(length));
+      //Every ngram adds to the totals of the context it begins with, new totals start at 0
+      forEachNgram(length + 1, [&table](const TokenId * key_in, int count_in) {
+        ContextTotals * current = table.insert(key_in);
+        current->successorTotal += count_in;
+        current->numSuccessors += 1;
+      });
+      for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+        iterator.value().count = countIds(iterator.key(), length);
+      }
+    }
+
+    return 0;
+  }
+
+  //Finds the totals of the ngrams that follow a context
+  template <class Type> int Document<Type>::findTotals(const TokenId * context_in, int length_in, ContextTotals * location_in) {
+    ContextTotals * result;
+
+    //Single tokens follow the empty context, which occurs at every position
+    if (length_in == 0 && hasNgrams(1) == 1) {
+      location_in->count = numTokens;
+      location_in->successorTotal = numNgrams(1);
+      location_in->numSuccessors = numDistinctNgrams(1);
+      return 0;
+    }
+    if (length_in < 1 || length_in > (int) totals.size()) {
+      return -1;
+    }
+    result = totals[length_in - 1].find(context_in);
+    if (result == NULL) {
+      //Nothing follows the context, though it may still end the document
+      location_in->count = countIds(context_in, length_in);
+      location_in->successorTotal = 0;
+      location_in->numSuccessors = 0;
+      return 0;
+    }
+    *location_in = *result;
+
+    return 0;
+  }
+
+  //Builds a bloom filter of the ngrams of every length read
+  template <class Type> int Document<Type>::buildFilters(double falsePositiveRate_in, size_t numBytes_in) {
+    std::vector<size_t> sizes;
+    size_t totalSize;
+    int lengthIterator;
+
+    //Sketches estimate ngrams their tables do not hold, which a filter would rule out
+    if (! sketches.empty()) {
+      return -1;
+    }
+    //Each filter is sized for the rate, then they are all shrunk together to fit the budget
+    totalSize = 0;
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      sizes.push_back(BloomFilter::bytesNeeded(numDistinctNgrams(ngramLengths[lengthIterator]), falsePositiveRate_in));
+      totalSize += sizes.back();
+    }
+    if (numBytes_in > 0 && totalSize > numBytes_in) {
+      for (lengthIterator = 0; lengthIterator < (int) sizes.size(); ++lengthIterator) {
+        sizes[lengthIterator] = (size_t) ((double) sizes[lengthIterator] * numBytes_in / totalSize);
+      }
+    }
+
+    //The filters are sized in place rather than copied into the list
+    filters = std::vector<BloomFilter>(ngramLengths.size());
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      BloomFilter & filter = filters[lengthIterator];
+      filter.reset(sizes[lengthIterator]);
+      forEachNgram(ngramLengths[lengthIterator], [&](const TokenId * key_in, int) {
+        filter.add(NgramTable<int>::hashKey(key_in, ngramLengths[lengthIterator]));
+      });
+    }
+
+    return 0;
+  }
+
+  //Finds how often the bloom filter of a length has been checked and what it decided
+  template <class Type> int Document<Type>::getFilterStats(int length_in, BloomStats * location_in) {
+    int index;
+
+    index = getIndex(length_in);
+    if (index >= (int) filters.size() || filters[index].size() == 0) {
+      return -1;
+    }
+
+    return filters[index].getStats(location_in);
+  }
+
+  //Finds the size and error bound of the sketch of a length
+  template <class Type> int Document<Type>::getSketchStats(int length_in, SketchStats * location_in) {
+    int index;
+
+    index = getIndex(length_in);
+    if (index >= (int) sketches.size() || sketches[index].size() == 0) {
+      return -1;
+    }
+    sketches[index].getStats(location_in);
+    location_in->numHeavy = dictionary[index].size();
+
+    return 0;
+  }
+
+  //Finds the most frequent ngrams of a length held in its table
+  template <class Type> int Document<Type>::heavyHitters(int length_in, int numResults_in, std::vector<std::pair<std::vector<Type>, int>> * location_in) {
+    std::vector<std::pair<int, const TokenId*>> entries;
+    int resultIterator;
+    int keyIterator;
+    int index;
+
+    index = getIndex(length_in);
+    if (index >= (int) ngramLengths.size()) {
+      return -1;
+    }
+
+    //forEachNgram refuses sketched lengths, but the heavy hitters are exactly what their tables hold
+    if (index < (int) sketches.size() && sketches[index].size() > 0) {
+      for (auto iterator = dictionary[index].begin(); iterator != dictionary[index].end(); ++iterator) {
+        entries.push_back(std::make_pair(iterator.value(), iterator.key()));
+      }
+    } else {
+      forEachNgram(length_in, [&](const TokenId * key_in, int count_in) {
+        entries.push_back(std::make_pair(count_in, key_in));
+      });
+    }
+    //Only the first results need to be in order
+    numResults_in = std::max(0, std::min(numResults_in, (int) entries.size()));
+    std::partial_sort(entries.begin(), entries.begin() + numResults_in, entries.end(), [](const std::pair<int, const TokenId*> & first_in,
+      const std::pair<int, const TokenId*> & second_in) {
+      return first_in.first > second_in.first;
+    });
+
+    location_in->clear();
+    for (resultIterator = 0; resultIterator < numResults_in; ++resultIterator) {
+      location_in->push_back(std::make_pair(std::vector<Type>(), entries[resultIterator].first));
+      for (keyIterator = 0; keyIterator < length_in; ++keyIterator) {
+        location_in->back().first.push_back(*lexicon.getToken(entries[resultIterator].second[keyIterator]));
+      }
+    }
+
+    return 0;
+  }
+
+  //Sorts the ngrams of every length read by a 64 bit fingerprint of their tokens
+  template <class Type> int Document<Type>::buildFingerprints() {
+    std::vector<unsigned long long> tokenHashes;
+    std::vector<unsigned long long> ngramHashes;
+    std::vector<std::pair<unsigned long long, const TokenId*>> entries;
+    TokenId tokenIterator;
+    int lengthIterator;
+
+    //The fingerprints are the hashes MinHash signatures are made from, which only depend on the tokens
+    tokenHashes.resize(lexicon.size());
+    for (tokenIterator = 0; tokenIterator < (TokenId) lexicon.size(); ++tokenIterator) {
+      tokenHashes[tokenIterator] = MinHasher<Type>::hashToken(lexicon.getToken(tokenIterator));
+    }
+
+    fingerprints = std::vector<FingerprintList>(ngramLengths.size());
+    for (lengthIterator = 0; lengthIterator < (int) ngramLengths.size(); ++lengthIterator) {
+      FingerprintList & list = fingerprints[lengthIterator];
+      int length = ngramLengths[lengthIterator];
+      size_t entryIterator;
+
+      entries.clear();
+      ngramHashes.resize(length);
+      if (forEachNgram(length, [&](const TokenId * key_in, int) {
+        int keyIterator;
+
+        for (keyIterator = 0; keyIterator < length; ++keyIterator) {
+          ngramHashes[keyIterator] = tokenHashes[key_in[keyIterator]];
+        }
+        entries.push_back(std::make_pair(MinHasher<Type>::hashNgram(ngramHashes.data(), length), key_in));
+      })) {
+        //Fingerprints of only some lengths would be taken for the full lists
+        fingerprints.clear();
+        return -1;
+      }
+      std::sort(entries.begin(), entries.end(), [](const std::pair<unsigned long long, const TokenId*> & first_in,
+        const std::pair<unsigned long long, const TokenId*> & second_in) {
+        return first_in.first < second_in.first;
+      });
+
+      list.fingerprints.resize(entries.size());
+      list.keys.resize(entries.size() * length);
+      for (entryIterator = 0; entryIterator < entries.size(); ++entryIterator) {
+        list.fingerprints[entryIterator] = entries[entryIterator].first;
+        std::copy(entries[entryIterator].second, entries[entryIterator].second + length, list.keys.begin() + entryIterator * length);
+      }
+    }
+
+    return 0;
+  }
+
+  //Finds the bytes a table of ngrams would use once it holds a number of entries
+  template <class Type> size_t Document<Type>::tableBytes(int length_in, int numEntries_in) {
+    size_t numSlots;
+
+    //Tables double from their smallest size until they are at most three quarters full
+    numSlots = NGRAM_TABLE_MIN_CAPACITY;
+    while ((size_t) numEntries_in * 4 > numSlots * 3) {
+      numSlots = numSlots * 2;
+    }
+
+    return numSlots * ((length_in + 1) * sizeof(unsigned int) + sizeof(int));
+  }
+
+  //Finds the perplexity of a model on a list of sentences
+  template <class Type> double Document<Type>::perplexity(LanguageModel<Type> * model_in, int length_in, std::vector<std::vector<Type>> * sentences_in) {
+    BatchScorer<Type> scorer(model_in, length_in, 1);
+    std::vector<double> logProbabilities;
+    double logTotal;
+    size_t numScored;
+    size_t sentenceIterator;
+
+    scorer.logSentenceProbabilities(sentences_in, &logProbabilities);
+    logTotal = 0;
+    numScored = 0;
+    for (sentenceIterator = 0; sentenceIterator < sentences_in->size(); ++sentenceIterator) {
+      logTotal += logProbabilities[sentenceIterator];
+      numScored += (*sentences_in)[sentenceIterator].size();
+    }
+
+    return numScored == 0 ? 0 : exp(-logTotal / numScored);
+  }
+
+  //Drops ngrams longer than 1 that barely change the probabilities of the document
+  template <class Type> int Document<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in) {
+    std::vector<NgramTable<PruneScore>> scores;
+    std::vector<std::vector<float>> sorted;
+    std::vector<float> candidates;
+    size_t unigramBytes;
+    size_t low;
+    size_t high;
+    float threshold;
+    int lengthIterator;
+    int longest;
+
+    //The counts of a model file or a trie are read only and the sketches can not drop ngrams
+    if (! frozen.empty() || trie.getLength() > 0 || ! sketches.empty()) {
+      return -1;
+    }
+    longest = ngramLengths.empty() ? 0 : *std::max_element(ngramLengths.begin(), ngramLengths.end());
+    for (lengthIterator = 1; lengthIterator <= longest; ++lengthIterator) {
+      if (getIndex(lengthIterator) >= (int) ngramLengths.size()) {
+        return -2;
+      }
+    }
+
+    if (location_in != NULL) {
+      location_in->numBefore.clear();
+      location_in->bytesBefore = 0;
+      for (lengthIterator = 1; lengthIterator <= longest; ++lengthIterator) {
+        location_in->numBefore.push_back(dictionary[getIndex(lengthIterator)].size());
+        location_in->bytesBefore += dictionary[getIndex(lengthIterator)].memoryUsage();
+      }
+    }
+
+    //Longer ngrams are scored first so each can raise the score of the two ngrams it contains
+    scores.resize(longest + 1);
+    sorted.resize(longest + 1);
+    for (lengthIterator = longest; lengthIterator >= 2; --lengthIterator) {
+      NgramTable<int> & table = dictionary[getIndex(lengthIterator)];
+      NgramTable<int> & shorter = dictionary[getIndex(lengthIterator - 1)];
+      NgramTable<int> * shortest = lengthIterator > 2 ? &dictionary[getIndex(lengthIterator - 2)] : NULL;
+      int length = lengthIterator;
+      int cutoff = cutoffs_in != NULL && length - 1 < (int) cutoffs_in->size() ? (*cutoffs_in)[length - 1] : 0;
+
+      int numOnce = 0;
+      int numTwice = 0;
+      double discount;
+
+      //The training counts overrate rare ngrams, so each is lowered by the absolute discount n1 / (n1 + 2 n2)
+      for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+        numOnce += iterator.value() == 1;
+        numTwice += iterator.value() == 2;
+      }
+      discount = numOnce + numTwice > 0 ? (double) numOnce / (numOnce + 2 * numTwice) : 0;
+      //Without any ngrams seen twice the discount would take every singleton's whole count
+      discount = discount > PRUNE_MAX_DISCOUNT ? PRUNE_MAX_DISCOUNT : discount;
+
+      if (scores[length].getLength() != length) {
+        scores[length] = NgramTable<PruneScore>(length);
+      }
+      scores[length].reserve(table.size());
+      for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+        const TokenId * key = iterator.key();
+        int count = iterator.value();
+        int * contextCount;
+        int * shorterCount;
+        int * shorterContextCount;
+        PruneScore * score;
+        PruneScore * child;
+        double entropy;
+
+        //P(token | context) against P(token | context without its first token)
+        contextCount = shorter.find(key);
+        shorterCount = shorter.find(key + 1);
+        shorterContextCount = shortest != NULL ? shortest->find(key + 1) : NULL;
+        if (count <= cutoff) {
+          entropy = -HUGE_VAL;
+        } else if (contextCount == NULL || shorterCount == NULL || (shortest != NULL && shorterContextCount == NULL)) {
+          entropy = HUGE_VAL;
+        } else {
+          entropy = (count - discount) / numNgrams(length) * log(((count - discount) / *contextCount) /
+            ((double) *shorterCount / (shortest != NULL ? *shorterContextCount : numNgrams(1))));
+        }
+        //A score that is not a number can not be sorted or compared with the threshold, so it counts as no change
+        if (entropy != entropy) {
+          entropy = 0;
+        }
+
+        score = scores[length].insert(key);
+        score->score = score->hasChildren && score->childScore > entropy ? score->childScore : (float) entropy;
+        sorted[length].push_back(score->score);
+        //The context and the shorter ngram can not be dropped while this ngram is kept
+        if (length > 2) {
+          if (scores[length - 1].getLength() != length - 1) {
+            scores[length - 1] = NgramTable<PruneScore>(length - 1);
+          }
+          child = scores[length - 1].insert(key);
+          child->childScore = child->hasChildren && child->childScore > score->score ? child->childScore : score->score;
+          child->hasChildren = 1;
+          child = scores[length - 1].insert(key + 1);
+          child->childScore = child->hasChildren && child->childScore > score->score ? child->childScore : score->score;
+          child->hasChildren = 1;
+        }
+      }
+      std::sort(sorted[length].begin(), sorted[length].end());
+    }
+
+    //Without a threshold only the ngrams below a cutoff score low enough to be dropped
+    threshold = threshold_in > 0 ? (float) threshold_in : -FLT_MAX;
+    unigramBytes = dictionary[getIndex(1)].memoryUsage();
+    auto bytesAt = [&](float threshold_in) {
+      size_t result;
+      int length;
+
+      result = unigramBytes;
+      for (length = 2; length <= longest; ++length) {
+        result += tableBytes(length, sorted[length].end() - std::lower_bound(sorted[length].begin(), sorted[length].end(), threshold_in));
+      }
+      return result;
+    };
+    //The bytes only fall as the threshold rises, so the least threshold that fits is searched for among the scores
+    if (numBytes_in > 0 && bytesAt(threshold) > numBytes_in) {
+      for (lengthIterator = 2; lengthIterator <= longest; ++lengthIterator) {
+        candidates.insert(candidates.end(), std::upper_bound(sorted[lengthIterator].begin(), sorted[lengthIterator].end(), threshold), sorted[lengthIterator].end());
+      }
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+      candidates.push_back(HUGE_VALF);
+      low = 0;
+      high = candidates.size() - 1;
+      while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (bytesAt(candidates[middle]) > numBytes_in) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      threshold = candidates[low];
+    }
+
+    //Tables can not remove entries so each length is copied into a table of the ngrams kept
+    for (lengthIterator = 2; lengthIterator <= longest; ++lengthIterator) {
+      NgramTable<int> & table = dictionary[getIndex(lengthIterator)];
+      NgramTable<int> kept(lengthIterator);
+
+      kept.reserve(sorted[lengthIterator].end() - std::lower_bound(sorted[lengthIterator].begin(), sorted[lengthIterator].end(), threshold));
+      for (auto iterator = table.begin(); iterator != table.end(); ++iterator) {
+        if (scores[lengthIterator].find(iterator.key())->score >= threshold) {
+          *kept.insert(iterator.key()) = iterator.value();
+        }
+      }
+      table = std::move(kept);
+    }
+    //Nothing cached from the old counts still holds, the totals are found again from the ngrams kept
+    buildTotals();
+    filters.clear();
+    fingerprints.clear();
+
+    if (location_in != NULL) {
+      location_in->numAfter.clear();
+      location_in->bytesAfter = 0;
+      for (lengthIterator = 1; lengthIterator <= longest; ++lengthIterator) {
+        location_in->numAfter.push_back(dictionary[getIndex(lengthIterator)].size());
+        location_in->bytesAfter += dictionary[getIndex(lengthIterator)].memoryUsage();
+      }
+      location_in->threshold = threshold;
+      location_in->perplexityBefore = 0;
+      location_in->perplexityAfter = 0;
+    }
+
+    return 0;
+  }
+
+  //Prunes the document and finds the perplexity of a model built on it over held out sentences before and after
+  template <class Type> int Document<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in,
+    int length_in, std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in) {
+    double before;
+    int result;
+
+    before = perplexity(model_in, length_in, heldOut_in);
+    result = prune(cutoffs_in, threshold_in, numBytes_in, location_in);
+    if (result != 0) {
+      return result;
+    }
+    location_in->perplexityBefore = before;
+    location_in->perplexityAfter = perplexity(model_in, length_in, heldOut_in);
+
+    return 0;
+  }
+
+  //Packs the counts of every length into a trie
+  template <class Type> int Document<Type>::buildTrie() {
+    std::vector<NgramTable<int>*> tables;
+    int lengthIterator;
+    int index;
+
+    //The tables of sketched lengths only hold the heavy hitters
+    if (! frozen.empty() || ! sketches.empty()) {
+      return -1;
+    }
+    if (trie.getLength() > 0) {
+      return 0;
+    }
+    //Every ngram needs the ngram one shorter than it as its context
+    for (lengthIterator = 1; lengthIterator <= (int) ngramLengths.size(); ++lengthIterator) {
+      index = getIndex(lengthIterator);
+      if (index == (int) ngramLengths.size()) {
+        return -1;
+      }
+      tables.push_back(&dictionary[index]);
+    }
+    if (tables.empty() || trie.build(&tables, lexicon.size())) {
+      return -1;
+    }
+
+    //Release the tables and totals now that the trie holds the counts and finds each context on the way to its ngrams
+    totals.clear();
+    for (lengthIterator = 0; lengthIterator < (int) dictionary.size(); ++lengthIterator) {
+      dictionary[lengthIterator] = NgramTable<int>(dictionary[lengthIterator].getLength());
+    }
+
+    return 0;
+  }
+
+  //Packs the counts of the trie, building it first if it has not been
+  template <class Type> int Document<Type>::packCounts() {
+    if (buildTrie()) {
+      return -1;
+    }
+    return trie.pack();
+  }
+
+  //Finds the number of bytes used by the counts of the document and its quantized probabilities
+  template <class Type> size_t Document<Type>::memoryUsage() {
+    size_t result;
+    int lengthIterator;
+
+    result = trie.memoryUsage();
+    for (lengthIterator = 0; lengthIterator < (int) dictionary.size(); ++lengthIterator) {
+      result += dictionary[lengthIterator].memoryUsage();
+    }
+    for (lengthIterator = 0; lengthIterator < (int) totals.size(); ++lengthIterator) {
+      result += totals[lengthIterator].memoryUsage();
+    }
+    for (lengthIterator = 0; lengthIterator < (int) quantized.size(); ++lengthIterator) {
+      result += quantized[lengthIterator].memoryUsage();
+    }
+
+    return result;
   }
 
   //Checks if an nGram occurs in this document
   template <class Type> int Document<Type>::hasNgram(std::vector<Type> * nGram_in) {
-    int index;
+    return countNgram(nGram_in) > 0 ? 1 : 0;
+  }
 
-    index = getIndex(nGram_in->size());
-    return dictionary[index].count(*nGram_in) > 0 ? 1 : 0;
+  //Checks if an nGram viewed in place occurs in this document
+  template <class Type> int Document<Type>::hasNgram(const Type * nGram_in, int length_in) {
+    return countNgram(nGram_in, length_in) > 0 ? 1 : 0;
   }
 
   //Adds an nGram to the dictionary
   template <class Type> int Document<Type>::addNgram(std::vector<Type> * nGram_in) {
+    std::vector<TokenId> ids;
     int index;
-    
-    index = getIndex(nGram_in->size());
-    //Add the nGram to the database
-    if (dictionary[index].count(*nGram_in) == 0) {
-      //If nGram is not in dictionary add it as count 1
-      dictionary[index][*nGram_in] = 1;
+
+    //The counts of a model file or a trie are read only
+    if (! frozen.empty() || trie.getLength() > 0) {
+      return -1;
+    }
+    lexicon.addTokens(nGram_in, &ids);
+    index = getIndex(ids.size());
+    //The cached totals no longer match the counts and the filters and fingerprints may not hold the ngram
+    totals.clear();
+    filters.clear();
+    fingerprints.clear();
+    //Add the nGram to the database, new ngrams start at a count of 0
+    if (index < (int) sketches.size() && sketches[index].size() > 0) {
+      countSketched(&dictionary[index], &sketches[index], ids.data(), NgramTable<int>::hashKey(ids.data(), ids.size()));
     } else {
-      //If ngram is in dictionary increase count
-      dictionary[index][*nGram_in] = dictionary[index][*nGram_in] + 1;
+      *dictionary[index].insert(ids.data()) += 1;
     }
+
     return 0;
   }
 
@@ -185,60 +1272,297 @@ namespace nlp {
     return dictionary.size();
   }
 
+  //Finds the identifier each of this document's tokens has in another document
+  template <class Type> int Document<Type>::mapIds(Document * document_in, std::vector<TokenId> * location_in) {
+    int idIterator;
+
+    location_in->clear();
+    for (idIterator = 0; idIterator < lexicon.size(); ++idIterator) {
+      location_in->push_back(document_in->lexicon.findToken(lexicon.getToken(idIterator)));
+    }
+
+    return 0;
+  }
+
+  //Finds the lexicon mapping this document's tokens to their identifiers
+  template <class Type> Lexicon<Type> * Document<Type>::getLexicon() {
+    return &lexicon;
+  }
+
   //Finds the number of ngrams in this document that are also in the specified document
-  template <class Type> int Document<Type>::numCommon(int length_in, Document * document_in) {
+  template <class Type> int Document<Type>::numCommon(int length_in, Document * document_in, int * location_in) {
+    //Sketches can not list their ngrams and overestimate the ngrams of the other document
+    if (isSketched(length_in) == 1 || document_in->isSketched(length_in) == 1) {
+      return -1;
+    }
+    *location_in = matchNgrams(length_in, document_in, NULL);
+
+    return 0;
+  }
+
+  //Shows the ngrams of a specified length in this document that are also in a specifeid document
+  template <class Type> int Document<Type>::findCommon(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in) {
+    if (isSketched(length_in) == 1 || document_in->isSketched(length_in) == 1) {
+      return -1;
+    }
+    matchNgrams(length_in, document_in, result_in);
+
+    return 0;
+  }
+
+  //Finds the ngrams of a length two documents share, merging fingerprints when both have them
+  template <class Type> int Document<Type>::matchNgrams(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in) {
+    std::vector<TokenId> otherIds;
+    std::vector<TokenId> currentNgram;
     int result;
-    int index;
+
+    //Two sorted lists are merged rather than probing the other document for every ngram
+    if (hasFingerprints(length_in) && document_in->hasFingerprints(length_in)) {
+      return intersectFingerprints(length_in, document_in, result_in);
+    }
 
     result = 0;
-    index = getIndex(length_in);
+    //Translate identifiers once rather than once per ngram
+    mapIds(document_in, &otherIds);
 
-    for (auto iterator = dictionary[index].begin(); iterator != dictionary[index].end(); ++iterator) {
-      std::vector<Type> currentNgram = iterator->first;
-      if (document_in->hasNgram(&currentNgram)) {
-        ++result;
+    forEachNgram(length_in, [&](const TokenId * key_in, int) {
+      int tokenIterator;
+
+      currentNgram.clear();
+      for (tokenIterator = 0; tokenIterator < length_in; ++tokenIterator) {
+        //Tokens the other document never saw can not be in a common ngram
+        if (otherIds[key_in[tokenIterator]] == UNKNOWN_TOKEN_ID) {
+          return;
+        }
+        currentNgram.push_back(otherIds[key_in[tokenIterator]]);
       }
-    }
+      //Check if the ngram is in the specified document
+      if (! document_in->countIds(&currentNgram)) {
+        return;
+      }
+      //Add the ngram to the result list
+      if (result_in != NULL) {
+        result_in->push_back(std::vector<Type>());
+        lexicon.getTokens(key_in, length_in, &result_in->back());
+      }
+      //Increase the counter
+      ++result;
+    });
 
     return result;
   }
 
-  //Shows the ngrams of a specified length in this document that are also in a specifeid document
-  template <class Type> int Document<Type>::findCommon(int length_in, Document * document_in, std::vector<const std::vector<Type>*> * result_in) {
-    int index;
+  //Finds the first of a sorted list of fingerprints that is not less than a target
+  template <class Type> size_t Document<Type>::gallop(const unsigned long long * values_in, size_t begin_in, size_t end_in, unsigned long long target_in) {
+    size_t step;
+    size_t low;
+    size_t high;
+
+    //Double the step until it passes the target, which then lies between the last two places checked
+    low = begin_in;
+    step = 1;
+    while (low + step < end_in && values_in[low + step] < target_in) {
+      low += step;
+      step *= 2;
+    }
+    high = low + step < end_in ? low + step : end_in;
+    if (low < end_in && values_in[low] >= target_in) {
+      return low;
+    }
+
+    return std::lower_bound(values_in + low + 1, values_in + high, target_in) - values_in;
+  }
+
+  //Finds the ngrams of a length two documents share by merging their sorted fingerprints
+  template <class Type> int Document<Type>::intersectFingerprints(int length_in, Document * document_in, std::vector<std::vector<Type>> * result_in) {
+    FingerprintList * first;
+    FingerprintList * second;
+    size_t firstIterator;
+    size_t secondIterator;
+    size_t firstEnd;
+    size_t secondEnd;
+    size_t firstSize;
+    size_t secondSize;
     int result;
 
+    first = &fingerprints[getIndex(length_in)];
+    second = &document_in->fingerprints[document_in->getIndex(length_in)];
+    firstSize = first->fingerprints.size();
+    secondSize = second->fingerprints.size();
+
     result = 0;
-    index = getIndex(length_in);
+    firstIterator = 0;
+    secondIterator = 0;
+    while (firstIterator < firstSize && secondIterator < secondSize) {
+      //Galloping skips runs of fingerprints the other list does not have in about the log of their length
+      if (first->fingerprints[firstIterator] < second->fingerprints[secondIterator]) {
+        firstIterator = gallop(first->fingerprints.data(), firstIterator, firstSize, second->fingerprints[secondIterator]);
+        continue;
+      }
+      if (second->fingerprints[secondIterator] < first->fingerprints[firstIterator]) {
+        secondIterator = gallop(second->fingerprints.data(), secondIterator, secondSize, first->fingerprints[firstIterator]);
+        continue;
+      }
 
-    for (auto iterator = dictionary[index].begin(); iterator != dictionary[index].end(); ++iterator) {
-      std::vector<Type> currentNgram = iterator->first;
-      //Check if the ngram is in the specified document
-      if (document_in->hasNgram(&currentNgram)) {
-        //Add pointer to the ngram to the result list
-        result_in->push_back(&iterator->first);
-        //Increase the counter
-        ++result;
+      //Every ngram with the fingerprint is checked token by token so a collision is never counted
+      for (firstEnd = firstIterator; firstEnd < firstSize && first->fingerprints[firstEnd] == first->fingerprints[firstIterator]; ++firstEnd);
+      for (secondEnd = secondIterator; secondEnd < secondSize && second->fingerprints[secondEnd] == second->fingerprints[secondIterator]; ++secondEnd);
+      for (; firstIterator < firstEnd; ++firstIterator) {
+        const TokenId * firstKey = &first->keys[firstIterator * length_in];
+        size_t matchIterator;
+
+        for (matchIterator = secondIterator; matchIterator < secondEnd; ++matchIterator) {
+          const TokenId * secondKey = &second->keys[matchIterator * length_in];
+          int tokenIterator;
+
+          for (tokenIterator = 0; tokenIterator < length_in; ++tokenIterator) {
+            if (! (*lexicon.getToken(firstKey[tokenIterator]) == *document_in->lexicon.getToken(secondKey[tokenIterator]))) {
+              break;
+            }
+          }
+          if (tokenIterator == length_in) {
+            if (result_in != NULL) {
+              result_in->push_back(std::vector<Type>());
+              lexicon.getTokens(firstKey, length_in, &result_in->back());
+            }
+            ++result;
+            break;
+          }
+        }
       }
+      secondIterator = secondEnd;
     }
 
     return result;
   }
 
+  //Checks if a document has sorted fingerprints of a length
+  template <class Type> int Document<Type>::hasFingerprints(int length_in) {
+    return getIndex(length_in) < (int) fingerprints.size();
+  }
+
+  //Finds the overlap of rows of the matrix until none are left
+  template <class Type> int Document<Type>::overlapRows(int length_in, std::vector<Document*> * documents_in, std::atomic<int> * next_in, std::vector<std::vector<int>> * location_in) {
+    int row;
+    int column;
+
+    //Rows are taken in order so the longest ones start first
+    while ((row = (*next_in)++) < (int) documents_in->size()) {
+      for (column = row + 1; column < (int) documents_in->size(); ++column) {
+        //Each pair is written by the one thread that owns its row so no locking is needed
+        (*location_in)[row][column] = (*documents_in)[row]->intersectFingerprints(length_in, (*documents_in)[column], NULL);
+        (*location_in)[column][row] = (*location_in)[row][column];
+      }
+    }
+
+    return 0;
+  }
+
+  //Finds the number of ngrams every pair of documents shares
+  template <class Type> int Document<Type>::overlapMatrix(int length_in, std::vector<Document*> * documents_in, int numThreads_in, std::vector<std::vector<int>> * location_in) {
+    std::vector<std::thread> threads;
+    std::atomic<int> next;
+    int documentIterator;
+    int threadIterator;
+
+    location_in->assign(documents_in->size(), std::vector<int>(documents_in->size(), 0));
+    for (documentIterator = 0; documentIterator < (int) documents_in->size(); ++documentIterator) {
+      Document * document = (*documents_in)[documentIterator];
+      if (document->getIndex(length_in) >= (int) document->ngramLengths.size()) {
+        return -1;
+      }
+      //Fingerprints are built before the threads start since they are shared by every row
+      if (! document->hasFingerprints(length_in) && document->buildFingerprints()) {
+        return -1;
+      }
+      (*location_in)[documentIterator][documentIterator] = document->fingerprints[document->getIndex(length_in)].fingerprints.size();
+    }
+
+    next = 0;
+    if (numThreads_in <= 1 || documents_in->size() <= 2) {
+      return overlapRows(length_in, documents_in, &next, location_in);
+    }
+    for (threadIterator = 0; threadIterator < std::min(numThreads_in, (int) documents_in->size() - 1); ++threadIterator) {
+      threads.push_back(std::thread(&Document<Type>::overlapRows, length_in, documents_in, &next, location_in));
+    }
+    for (threadIterator = 0; threadIterator < (int) threads.size(); ++threadIterator) {
+      threads[threadIterator].join();
+    }
+
+    return 0;
+  }
+
+  //Computes the MinHash signature of the set of ngrams of a length in this document
+  template <class Type> int Document<Type>::signature(int length_in, MinHasher<Type> * hasher_in, std::vector<unsigned int> * location_in) {
+    std::vector<unsigned long long> tokenHashes;
+    std::vector<unsigned long long> ngramHashes;
+    TokenId tokenIterator;
+
+    if (getIndex(length_in) >= (int) ngramLengths.size()) {
+      return -1;
+    }
+
+    //Hash every token once rather than once per ngram it is in
+    tokenHashes.resize(lexicon.size());
+    for (tokenIterator = 0; tokenIterator < (TokenId) lexicon.size(); ++tokenIterator) {
+      tokenHashes[tokenIterator] = MinHasher<Type>::hashToken(lexicon.getToken(tokenIterator));
+    }
+
+    hasher_in->resetSignature(location_in);
+    ngramHashes.resize(length_in);
+    if (forEachNgram(length_in, [&](const TokenId * key_in, int) {
+      int keyIterator;
+
+      for (keyIterator = 0; keyIterator < length_in; ++keyIterator) {
+        ngramHashes[keyIterator] = tokenHashes[key_in[keyIterator]];
+      }
+      hasher_in->addHash(MinHasher<Type>::hashNgram(ngramHashes.data(), length_in), location_in);
+    })) {
+      return -1;
+    }
+
+    return 0;
+  }
+
   //Checks if the document contains the specified sentence
   template <class Type> int Document<Type>::hasSentence(int ngramLength_in, std::vector<Type> * sentence_in) {
-    std::vector<Type> current;
+    return hasSentence(ngramLength_in, sentence_in->data(), sentence_in->size());
+  }
+
+  //Checks if the document contains a sentence viewed in place
+  template <class Type> int Document<Type>::hasSentence(int ngramLength_in, const Type * sentence_in, int length_in) {
+    TokenId ids[NGRAM_VIEW_LENGTH];
+    std::vector<TokenId> longIds;
+    TokenId * window;
     int sentenceIterator;
+    int windowLength;
+
+    //Without any ngrams to check only an empty sentence is contained
+    if (ngramLength_in < 1) {
+      return length_in > 0 ? 0 : 1;
+    }
+    if (ngramLength_in > NGRAM_VIEW_LENGTH) {
+      longIds.resize(ngramLength_in);
+      window = longIds.data();
+    } else {
+      window = ids;
+    }
 
-    for (sentenceIterator = 0; sentenceIterator < (int) sentence_in->size(); ++sentenceIterator) {
-      //Push the next word in the sentence on to the ngram to be checked
-      current.push_back((*sentence_in)[sentenceIterator]);
-      //If the sentence is too long remove the first word
-      if ((int) current.size() > ngramLength_in) {
-        current.erase(current.begin());
+    windowLength = 0;
+    for (sentenceIterator = 0; sentenceIterator < length_in; ++sentenceIterator) {
+      //The ngram ends at the current word and is at most the specified length
+      if (windowLength == ngramLength_in) {
+        memmove(window, window + 1, (windowLength - 1) * sizeof(TokenId));
+        --windowLength;
+      }
+      window[windowLength] = lexicon.findToken(&sentence_in[sentenceIterator]);
+      //A sentence with a token that was never seen can not be in the document
+      if (window[windowLength] == UNKNOWN_TOKEN_ID) {
+        return 0;
       }
+      ++windowLength;
       //Check if the ngram occurs in the dictionary
-      if (! hasNgram(&current)) {
+      if (! countIds(window, windowLength)) {
         return 0;
       }
     }
@@ -264,8 +1588,32 @@ namespace nlp {
     return 0;
   }
 
+  //Checks if grams of the specified length are counted in a sketch
+  template <class Type> int Document<Type>::isSketched(int length_in) {
+    int index;
+
+    //Check if the length is valid
+    if (length_in <= 0) {
+      return -1;
+    }
+    //Lengths that have not been read are not sketched
+    if (hasNgrams(length_in) != 1) {
+      return 0;
+    }
+    index = getIndex(length_in);
+    if (index < (int) sketches.size() && sketches[index].size() > 0) {
+      return 1;
+    }
+
+    return 0;
+  }
+
   //Default constructor and destructor
-  template <class Type> Document<Type>::Document() {}
+  template <class Type> Document<Type>::Document() {
+    numTokens = 0;
+    numThreads = 1;
+    sketchOptions = SketchOptions();
+  }
   template <class Type> Document<Type>::~Document() {}
 
 };
@@ -5,8 +5,8 @@
 * Created By: Nick DelBen
 * Created On: March 14, 2015
 *
-* Last Edited: March 14, 2015
-*   - Created initially
+* Last Edited: October 18, 2026
+*   - Added quantizing the probabilities of the stored ngrams
 **************************************************************/
 
 #ifndef _H_GT_DOCUMENT
@@ -14,21 +14,24 @@
 
 #include <string>        //  std::string
 #include <vector>        //  std::vector
-#include <unordered_map> //  std::unordered_map
-#include <cmath>         //  log()
+#include <map>           //  std::map
+#include <cmath>         //  log()   exp()   sqrt()
 
 #include "document.t.h"
 #include "languageModel.i.h"
 
+#define GT_DENSE_FREQUENCIES 1024
+#define GT_CONFIDENCE 1.96
+
 namespace nlp {
   
   template <typename Type> class GTDocument : public Document<Type>, public LanguageModel<Type> {
   private:
-    /* The frequency distrubutions for this document */
-    std::vector<std::unordered_map<int, int>> frequencies;
+    /* The frequency distrubutions for this document, the (count, frequency) pair of every count that occurs sorted by count */
+    std::vector<std::vector<FrequencyPair>> frequencies;
 
-    /* The probability distrubutions for this document */
-    std::vector<std::unordered_map<int, double>> probabilities;
+    /* The probability distrubutions for this document, the probability of an ngram indexed by its count for every count below the threshold */
+    std::vector<std::vector<double>> probabilities;
 
     /* The size of the vocabulary for this language model */
     int vocabulary;
@@ -42,6 +45,31 @@ namespace nlp {
     *******************/
     int setValues(int gramLenth_in);
 
+    /*******************
+    * Finds the probability of each count below the threshold for one length with Simple Good-Turing.
+    * The Turing estimate is used while it differs significantly from the smoothed estimate of a
+    * line fit to the log of the frequencies, and the smoothed estimate from then on
+    * @param  length_in length of the ngrams
+    * @return 0  success
+    * @return -1 the ngrams have fewer than two distinct counts so no line can be fit
+    *******************/
+    int fitProbabilities(int length_in);
+
+    /******************
+    * Computes the prabability of an ngram from the number of times it occurs
+    * @param  length_in length of the ngram
+    * @param  count_in  occurances of the ngram
+    * @return probability of an ngram occuring that many times
+    ******************/
+    double countProbability(int length_in, int count_in);
+
+    /******************
+    * Computes the probability of the token stored just after a state's context given the context
+    * @param  state_in state holding the context and the token
+    * @return probability of the token
+    ******************/
+    double nextProbability(ScorerState * state_in);
+
   public:
     /*******************
     * Creates a new instance of GTDocument finding all the ngrams 
@@ -71,6 +99,40 @@ namespace nlp {
     * @param vocabulary_in size of the vocabulary
     *******************/
     GTDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int threshold_in, int vocabulary_in);
+    /*******************
+    * Creates a new instance of GTDocument finding all the ngrams of the sizes specified in the
+    * input vector, counted on several threads
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param numThreads_in  number of threads to count with
+    * @param threshold_in   threshold for the good turing model
+    * @param vocabulary_in  size of the vocabulary
+    *******************/
+    GTDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in, int threshold_in, int vocabulary_in);
+    /*******************
+    * Creates a new instance of GTDocument from tokens that have already been given identifiers
+    * @param lexicon_in     lexicon the identifiers were taken from
+    * @param tokens_in      identifiers of the tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param threshold_in   threshold for the good turing model
+    * @param vocabulary_in  size of the vocabulary
+    *******************/
+    GTDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in, int threshold_in, int vocabulary_in);
+    /*******************
+    * Creates a new instance of GTDocument by counting ngrams as the tokens are read from a source
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param keepTokens_in  if this is >0 the tokens are also stored so more lengths can be read later
+    * @param threshold_in   threshold for the good turing model
+    * @param vocabulary_in  size of the vocabulary
+    *******************/
+    GTDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, int threshold_in, int vocabulary_in);
+    /*******************
+    * Creates a new instance of GTDocument that queries its counts directly from a mapped
+    * model file written by GTDocument::saveModel
+    * @param model_in model file to query the counts from
+    *******************/
+    GTDocument(ModelFile * model_in);
 
     //Default constructor and destructor
     GTDocument();
@@ -80,10 +142,55 @@ namespace nlp {
     * Creates the distrubutions for each frequency frequency
     * @param  length_in length of ngrams to create distrubutions for
     * @return 0  success
-    * @return -1 threshold too high
+    * @return -1 ngrams of a length were not read, are counted in a sketch or have too few distinct counts to fit
     ******************/
     int createFrequencyDistrubution(int length_in);
 
+    /******************
+    * Writes the document and its good turing tables to a model file
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written
+    ******************/
+    int saveModel(std::string fileName_in);
+
+    /******************
+    * Writes the probability of every stored ngram given the tokens before it to an ARPA file
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written or a length is counted in a sketch
+    * @return -2 the document does not hold every length from 1 to its longest length
+    ******************/
+    int saveArpa(std::string fileName_in);
+
+    /******************
+    * Prunes the document as Document::prune does with only the count cutoffs. The model does not back off,
+    * so the relative entropy scores would rate the dropped ngrams by a probability it never gives them
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in);
+
+    /******************
+    * Prunes the document with only the count cutoffs and scores held out sentences as Document::prune does
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in, int length_in,
+      std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in);
+
+    /******************
+    * Packs the counts as Document::packCounts does and stores the probability of every stored ngram
+    * as the code of a bin of its log, with the bins of each length chosen from its probabilities.
+    * Stored ngrams are then scored from their code alone, ngrams that are not stored as before.
+    * Changing the threshold or the vocabulary or creating the distrubutions again drops the codes
+    * @param  numBits_in number of bits of each code from 1 to QUANTIZED_MAX_BITS, 8 to 16 keeps the error small
+    * @return 0  success
+    * @return -1 the counts could not be packed into a trie
+    ******************/
+    int quantize(int numBits_in);
+
+
     /******************
     * Sets the documents threshold value
     * @param threshold_in new threshold value
@@ -129,6 +236,24 @@ namespace nlp {
     * @return prabability of sentence occurance
     ******************/
     double logSentenceProbability(int length_in, std::vector<Type> * sentence_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  token_in  token to score
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, Type * token_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  id_in     identifier of the token to score in the lexicon of the document
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, TokenId id_in);
   };
 
 };
@@ -9,43 +9,54 @@
 namespace nlp {
   //Sets the necessary parameters for the document
   template <typename Type> int GTDocument<Type>::setValues(int gramLenth_in) {
-    int lengthIterator;
-
-    for (lengthIterator = 0; lengthIterator < gramLenth_in; lengthIterator++) {
-      std::unordered_map<int, int> newMap1;
-      std::unordered_map<int, double> newMap2;
-      frequencies.push_back(newMap1);
-      probabilities.push_back(newMap2);
-    }
+    frequencies.assign(gramLenth_in, std::vector<FrequencyPair>());
+    probabilities.assign(gramLenth_in, std::vector<double>());
 
     return 0;
   }
-  
+
   //Creates the distrubutions for each frequency frequency
   template <typename Type> int GTDocument<Type>::createFrequencyDistrubution(int length_in) {
+    std::vector<int> lowFrequencies;
+    std::map<int, int> highFrequencies;
     int lengthIterator;
-    int frequencyIterator;
-    int index;
-    int occurances;
-    double normalizationConstant;
-    double numNgrams;
+    int countIterator;
+
+    if (length_in > (int) frequencies.size()) {
+      setValues(length_in);
+    }
+    //The codes were found from the old distrubutions
+    this->quantized.clear();
 
     //Create a distrubution for each ngram length
     for (lengthIterator = 0; lengthIterator < length_in; lengthIterator++) {
-      //Find the location of the current ngram length
-      index = this->getIndex(lengthIterator + 1);
-      //Iterate over the database and increase counts for each ngram length
-      for (auto iterator = this->dictionary[index].begin(); iterator != this->dictionary[index].end(); ++iterator) {
-        //Extract the number of times this ngram occurs
-        occurances = iterator->second;
-        //Increase the counter for ngrams that occur this many times
-        if (frequencies[lengthIterator].count(occurances) == 0) {
-          //If nothing of this count has occured before, set occurances to 1
-          frequencies[lengthIterator][occurances] = 1;
+      //Low counts are by far the most common so they are counted in an array
+      lowFrequencies.assign(GT_DENSE_FREQUENCIES, 0);
+      highFrequencies.clear();
+      if (this->forEachNgram(lengthIterator + 1, [&](const TokenId *, int count_in) {
+        if (count_in < GT_DENSE_FREQUENCIES) {
+          ++lowFrequencies[count_in];
         } else {
-          //If count has occured before increment frequency
-          frequencies[lengthIterator][occurances] = frequencies[lengthIterator][occurances] + 1;
-        }             
+          ++highFrequencies[count_in];
+        }
+      })) {
+        return -1;
+      }
+
+      frequencies[lengthIterator].clear();
+      for (countIterator = 1; countIterator < GT_DENSE_FREQUENCIES; ++countIterator) {
+        if (lowFrequencies[countIterator] > 0) {
+          FrequencyPair pair;
+          pair.count = countIterator;
+          pair.frequency = lowFrequencies[countIterator];
+          frequencies[lengthIterator].push_back(pair);
+        }
+      }
+      for (auto iterator = highFrequencies.begin(); iterator != highFrequencies.end(); ++iterator) {
+        FrequencyPair pair;
+        pair.count = iterator->first;
+        pair.frequency = iterator->second;
+        frequencies[lengthIterator].push_back(pair);
       }
     }
 
@@ -54,70 +65,251 @@ namespace nlp {
       return 0;
     }
 
-    //Find the number of ngrams we are normalizing for
-    numNgrams = (double) this->numNgrams(1);
-
     //Find the probabilities for the required good turing values
     for (lengthIterator = 0; lengthIterator < length_in; lengthIterator++) {
-      //Check to make sure probability of length 1 is non-zero
-      if (frequencies[lengthIterator].count(1) == 0) {
+      if (fitProbabilities(lengthIterator + 1)) {
         return -1;
       }
-      //Find the probability of an unseen ngram occuring
-      probabilities[lengthIterator][0] = frequencies[lengthIterator][1] / numNgrams;
-      //Calculate the normalization constant for this
-      normalizationConstant = 1 - probabilities[lengthIterator][0];     
-      //Only iterate over the values required for good turing
-      for (frequencyIterator = 1; frequencyIterator < threshold; frequencyIterator++) {
-        //Check to make sure frequency is nonzero
-        if (frequencies[lengthIterator].count(frequencyIterator + 1) == 0) {
-          return -1;
+    }
+
+    return 0;
+  }
+
+  //Finds the probability of each count below the threshold for one length with Simple Good-Turing
+  template <typename Type> int GTDocument<Type>::fitProbabilities(int length_in) {
+    std::vector<FrequencyPair> & pairs = frequencies[length_in - 1];
+    std::vector<double> & probability = probabilities[length_in - 1];
+    std::vector<double> logCounts;
+    std::vector<double> logFrequencies;
+    std::vector<int> lowFrequencies;
+    double numNgrams;
+    double meanX;
+    double meanY;
+    double covariance;
+    double variance;
+    double slope;
+    double smoothed;
+    double turing;
+    double adjusted;
+    double ratio;
+    double previous;
+    double next;
+    bool useTuring;
+    int pairIterator;
+    int countIterator;
+
+    probability.clear();
+    if (pairs.size() < 2) {
+      return -1;
+    }
+
+    //Frequencies are averaged over the gap to the counts around them before the log of each is fit to a line
+    meanX = 0;
+    meanY = 0;
+    logCounts.resize(pairs.size());
+    logFrequencies.resize(pairs.size());
+    for (pairIterator = 0; pairIterator < (int) pairs.size(); ++pairIterator) {
+      previous = pairIterator == 0 ? 0 : pairs[pairIterator - 1].count;
+      next = pairIterator + 1 < (int) pairs.size() ? pairs[pairIterator + 1].count : 2.0 * pairs[pairIterator].count - previous;
+      logCounts[pairIterator] = log((double) pairs[pairIterator].count);
+      logFrequencies[pairIterator] = log(2.0 * pairs[pairIterator].frequency / (next - previous));
+      meanX += logCounts[pairIterator];
+      meanY += logFrequencies[pairIterator];
+    }
+    meanX /= pairs.size();
+    meanY /= pairs.size();
+    covariance = 0;
+    variance = 0;
+    for (pairIterator = 0; pairIterator < (int) pairs.size(); ++pairIterator) {
+      covariance += (logCounts[pairIterator] - meanX) * (logFrequencies[pairIterator] - meanY);
+      variance += (logCounts[pairIterator] - meanX) * (logCounts[pairIterator] - meanX);
+    }
+    slope = covariance / variance;
+
+    //Frequencies of the counts that are needed are looked up in an array
+    lowFrequencies.assign(threshold + 1, 0);
+    for (pairIterator = 0; pairIterator < (int) pairs.size() && pairs[pairIterator].count <= threshold; ++pairIterator) {
+      lowFrequencies[pairs[pairIterator].count] = pairs[pairIterator].frequency;
+    }
+
+    //Find the number of ngrams we are normalizing for
+    numNgrams = (double) this->numNgrams(1);
+    probability.assign(threshold, 0);
+    //Find the probability of an unseen ngram occuring
+    probability[0] = lowFrequencies[1] / numNgrams;
+    useTuring = true;
+    for (countIterator = 1; countIterator < threshold; ++countIterator) {
+      //The fitted line gives the ratio of the frequencies of neighbouring counts directly
+      smoothed = (countIterator + 1) * pow(1.0 + 1.0 / countIterator, slope);
+      adjusted = smoothed;
+      if (useTuring && lowFrequencies[countIterator] > 0 && lowFrequencies[countIterator + 1] > 0) {
+        ratio = (double) lowFrequencies[countIterator + 1] / lowFrequencies[countIterator];
+        turing = (countIterator + 1) * ratio;
+        //Once the estimates are close the noisier Turing estimate is never used again
+        if (fabs(turing - smoothed) > GT_CONFIDENCE * sqrt((countIterator + 1) * (countIterator + 1) * ratio / lowFrequencies[countIterator] * (1 + ratio))) {
+          adjusted = turing;
+        } else {
+          useTuring = false;
         }
-        //Find the occurances of the word occuring
-        occurances = frequencies[lengthIterator][frequencyIterator];
-        //Extract the number of occurances for this number
-        probabilities[lengthIterator][frequencyIterator] = ((frequencyIterator + 1) * frequencies[lengthIterator][frequencyIterator + 1]) / (numNgrams * frequencies[lengthIterator][frequencyIterator]);
-        //Normalize the current probability
-        probabilities[lengthIterator][frequencyIterator] = probabilities[lengthIterator][frequencyIterator] * normalizationConstant;
+      } else {
+        useTuring = false;
       }
+      //Normalize the current probability
+      probability[countIterator] = adjusted / numNgrams * (1 - probability[0]);
     }
 
     return 0;
   }
 
+  //Writes the document and its good turing tables to a model file
+  template <typename Type> int GTDocument<Type>::saveModel(std::string fileName_in) {
+    ModelHeader header;
+    std::vector<std::vector<ProbabilityPair>> probabilityPairs;
+    int lengthIterator;
+    int countIterator;
+
+    header.kind = MODEL_KIND_GT;
+    header.delta = 0;
+    header.threshold = threshold;
+    header.vocabulary = vocabulary;
+
+    probabilityPairs.resize(probabilities.size());
+    for (lengthIterator = 0; lengthIterator < (int) probabilities.size(); ++lengthIterator) {
+      for (countIterator = 0; countIterator < (int) probabilities[lengthIterator].size(); ++countIterator) {
+        ProbabilityPair pair;
+        pair.count = countIterator;
+        pair.padding = 0;
+        pair.probability = probabilities[lengthIterator][countIterator];
+        probabilityPairs[lengthIterator].push_back(pair);
+      }
+    }
+
+    return this->writeModel(fileName_in, &header, &frequencies, &probabilityPairs);
+  }
+
+  //Writes the probability of every stored ngram given the tokens before it to an ARPA file
+  template <typename Type> int GTDocument<Type>::saveArpa(std::string fileName_in) {
+    return this->writeArpa(fileName_in, [this](std::vector<Type> * ngram_in) {
+      std::vector<Type> given(ngram_in->begin(), ngram_in->end() - 1);
+      std::vector<Type> newPart(1, ngram_in->back());
+      //Single tokens have no context so their probability is taken over the whole document
+      if (given.empty()) {
+        return ngramProbability(ngram_in);
+      }
+      return ngramProbabilityGiven(&given, &newPart);
+    });
+  }
+
+  //Prunes the document with only the count cutoffs
+  template <typename Type> int GTDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in) {
+    //Without backing off a dropped ngram gets a probability from the counts alone, not the probability its score was found with
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, location_in);
+  }
+
+  //Prunes the document with only the count cutoffs and scores held out sentences
+  template <typename Type> int GTDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in,
+    int length_in, std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in) {
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, model_in, length_in, heldOut_in, location_in);
+  }
+
+  //Stores the probability of every stored ngram as the code of a bin of its log
+  template <typename Type> int GTDocument<Type>::quantize(int numBits_in) {
+    return this->quantizeProbabilities(numBits_in, [this](ScorerState * state_in, int) {
+      return nextProbability(state_in);
+    });
+  }
+
   //Sets the documents threshold value
   template <typename Type> int GTDocument<Type>::setThreshold(int threshold_in) {
     threshold = threshold_in;
+    //The codes were found with the old threshold
+    this->quantized.clear();
     return 0;
   }
 
   //Sets the size of the vocabulary
   template <typename Type> int GTDocument<Type>::setVocabulary(int vocabulary_in) {
     vocabulary = vocabulary_in;
+    this->quantized.clear();
     return 0;
   }
 
   //Computes the prabability of an ngram occuring in the document
   template <typename Type> double GTDocument<Type>::ngramProbability(std::vector<Type> * ngram_in) {
-    int ngramCount;
-
     //Count the number of times the ngram occurs
-    ngramCount = this->countNgram(ngram_in);
+    return countProbability(ngram_in->size(), this->countNgram(ngram_in));
+  }
 
+  //Computes the prabability of an ngram from the number of times it occurs
+  template <typename Type> double GTDocument<Type>::countProbability(int length_in, int count_in) {
     //If the count is below our threshold use good-turing model
-    if (ngramCount < threshold) {
-       return probabilities[ngram_in->size() - 1][ngramCount];  
+    if (count_in < threshold) {
+      //Counts the tables were not made for have no probability
+      return count_in < (int) probabilities[length_in - 1].size() ? probabilities[length_in - 1][count_in] : 0;
     }
 
     //If count is greater than or equal to threshold use Maximum Likliehood estimation
-    return (double) (((double) this->countNgram(ngram_in)) / ((double) this->numNgrams(1)));
+    return (double) (((double) count_in) / ((double) this->numNgrams(1)));
+  }
+
+  //Computes the probability of the token stored just after a state's context given the context
+  template <typename Type> double GTDocument<Type>::nextProbability(ScorerState * state_in) {
+    int length;
+    int fullCount;
+    int givenCount;
+    double logProbability;
+
+    //Stored ngrams of a quantized document are scored from their code
+    if (this->quantizedProbability(state_in->context, state_in->contextLength + 1, &logProbability)) {
+      return exp(logProbability);
+    }
+
+    //Without any context the token is scored on its own
+    length = state_in->contextLength + 1;
+    if (length == 1) {
+      return countProbability(1, this->countIds(state_in->context, 1));
+    }
+    fullCount = this->countIdsGiven(state_in->context, length, length - 1, &givenCount);
+
+    //If the count is below threshold use good-turing model
+    if (fullCount < threshold) {
+      return countProbability(length, fullCount) / countProbability(length - 1, givenCount);
+    }
+
+    return ((double) fullCount) / ((double) givenCount);
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double GTDocument<Type>::advanceState(int length_in, ScorerState * state_in, Type * token_in) {
+    //Tokens never seen keep an identifier no ngram contains
+    return advanceState(length_in, state_in, this->lexicon.findToken(token_in));
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double GTDocument<Type>::advanceState(int length_in, ScorerState * state_in, TokenId id_in) {
+    double result;
+
+    trimState(state_in, length_in);
+    state_in->context[state_in->contextLength] = id_in;
+    result = log(nextProbability(state_in));
+    acceptState(state_in, length_in, result);
+
+    return result;
   }
 
   //Computes the prabability of an ngram occuring in the document given that some portion has already occured
   template <typename Type> double GTDocument<Type>::ngramProbabilityGiven(std::vector<Type> * given_in, std::vector<Type> * new_in) {
     std::vector<Type> fullNgram;
+    std::vector<TokenId> ids;
     int ngramIterator;
     int ngramCount;
+    int givenCount;
 
     //Create the full ngram to find the probability of
     fullNgram = *given_in;
@@ -125,37 +317,37 @@ namespace nlp {
       fullNgram.push_back((*new_in)[ngramIterator]);
     }
 
-    //Check the count of the full sentence
-    ngramCount = this->countNgram(&fullNgram);
+    //Check the count of the full sentence and of the given part together, an unseen token is never counted
+    ids.resize(fullNgram.size());
+    if (this->lexicon.findTokens(fullNgram.data(), fullNgram.size(), ids.data())) {
+      ngramCount = 0;
+      givenCount = this->countNgram(given_in);
+    } else {
+      ngramCount = this->countIdsGiven(ids.data(), ids.size(), given_in->size(), &givenCount);
+    }
 
     //If the count is below threshold use good-turing model
     if (ngramCount < threshold) {
       return ngramProbability(&fullNgram) / ngramProbability(given_in);
     }
 
-    return ((double) ((double) this->countNgram(&fullNgram)) / ((double) this->countNgram(given_in)));
+    return ((double) ngramCount) / ((double) givenCount);
   }
 
   //Computes the probability of a sentence occuring based on the implementing language model
   template <typename Type> double GTDocument<Type>::sentenceProbability(int length_in, std::vector<Type> * sentence_in) {
-    std::vector<Type> currentNgram;
+    ScorerState state;
     int tokenIterator;
     double result;
 
-    //Initially probability is simply probability of first word
-    currentNgram.push_back((*sentence_in)[0]);
-    result = ngramProbability(&currentNgram);
-
-    for (tokenIterator = 1; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
-      std::vector<Type> currentNew;
-      currentNew.push_back((*sentence_in)[tokenIterator]);
-      //Trim any excess tokens from the current given nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      result = result * ngramProbabilityGiven(&currentNgram, &currentNew);
-      //Add the new token to the end of the nGram
-      currentNgram.push_back((*sentence_in)[tokenIterator]);
+    resetState(&state);
+    result = 1;
+    for (tokenIterator = 0; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
+      trimState(&state, length_in);
+      state.context[state.contextLength] = this->lexicon.findToken(&(*sentence_in)[tokenIterator]);
+      result = result * nextProbability(&state);
+      //Only the product is kept so the state's log probability is left alone
+      acceptState(&state, length_in, 0);
     }
 
     return result;
@@ -163,35 +355,16 @@ namespace nlp {
 
   //Computes the probability of a sentence occuring based on the good-turing language model
   template <typename Type> double GTDocument<Type>::logSentenceProbability(int length_in, std::vector<Type> * sentence_in) {
-    double result;
+    ScorerState state;
     int sentenceIterator;
-    std::vector<Type> currentNgram;
 
-    currentNgram.push_back((*sentence_in)[0]);
-    result = log(ngramProbability(&currentNgram)); 
-
-    if (length_in == 1) {
-      for (sentenceIterator = 1; sentenceIterator < (int) sentence_in->size(); sentenceIterator++) {
-        std::vector<Type> currentNew;
-        currentNew.push_back((*sentence_in)[sentenceIterator]);
-        result = result + log(ngramProbability(&currentNew));
-      }
-      return result;
-    }
-    
-    for(sentenceIterator = 1; sentenceIterator < (int) sentence_in->size(); sentenceIterator++) {
-      std::vector<Type> currentNew;
-      currentNew.push_back((*sentence_in)[sentenceIterator]);
-      //Trim any excess tokens from the current nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      result = result + log(ngramProbabilityGiven(&currentNgram, &currentNew));
-      //Add the current token to the back of the current ngram
-      currentNgram.push_back((*sentence_in)[sentenceIterator]);
+    //The context of each token slides along in place rather than being copied
+    resetState(&state);
+    for (sentenceIterator = 0; sentenceIterator < (int) sentence_in->size(); sentenceIterator++) {
+      advanceState(length_in, &state, &(*sentence_in)[sentenceIterator]);
     }
 
-    return result;  
+    return state.logProbability;
   }
 
   //Creates a new instance of GTDocument finding all the ngrams
@@ -215,6 +388,61 @@ namespace nlp {
     :Document<Type>(tokens_in, gramLengths_in) {
     setThreshold(threshold_in);
     setVocabulary(vocabulary_in);
+    setValues(gramLengths_in->empty() ? 0 : *std::max_element(gramLengths_in->begin(), gramLengths_in->end()));
+  }
+
+  //Creates a new instance of GTDocument finding all the ngrams on several threads
+  template <typename Type> GTDocument<Type>::GTDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in, int threshold_in, int vocabulary_in)
+    :Document<Type>(tokens_in, gramLengths_in, numThreads_in) {
+    setThreshold(threshold_in);
+    setVocabulary(vocabulary_in);
+    setValues(gramLengths_in->empty() ? 0 : *std::max_element(gramLengths_in->begin(), gramLengths_in->end()));
+  }
+
+  //Creates a new instance of GTDocument from tokens that have already been given identifiers
+  template <typename Type> GTDocument<Type>::GTDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in, int threshold_in, int vocabulary_in)
+    :Document<Type>(lexicon_in, tokens_in, gramLengths_in) {
+    setThreshold(threshold_in);
+    setVocabulary(vocabulary_in);
+    setValues(gramLengths_in->empty() ? 0 : gramLengths_in->back());
+  }
+
+  //Creates a new instance of GTDocument by counting ngrams as the tokens are read from a source
+  template <typename Type> GTDocument<Type>::GTDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in, int threshold_in, int vocabulary_in)
+    :Document<Type>(source_in, gramLengths_in, keepTokens_in) {
+    setThreshold(threshold_in);
+    setVocabulary(vocabulary_in);
+    setValues(gramLengths_in->empty() ? 0 : gramLengths_in->back());
+  }
+
+  //Creates a new instance of GTDocument that queries its counts directly from a mapped model file
+  template <typename Type> GTDocument<Type>::GTDocument(ModelFile * model_in)
+    :Document<Type>(model_in) {
+    const FrequencyPair * frequencyPairs;
+    const ProbabilityPair * probabilityPairs;
+    int numFrequencies;
+    int numProbabilities;
+    int lengthIterator;
+    int pairIterator;
+
+    setThreshold(model_in->getHeader()->threshold);
+    setVocabulary(model_in->getHeader()->vocabulary);
+    setValues(this->ngramLengths.empty() ? 0 : *std::max_element(this->ngramLengths.begin(), this->ngramLengths.end()));
+
+    //The good turing tables are small so they are read into memory
+    for (lengthIterator = 0; lengthIterator < (int) frequencies.size(); ++lengthIterator) {
+      if (model_in->getFrequencies(lengthIterator, &frequencyPairs, &numFrequencies, &probabilityPairs, &numProbabilities)) {
+        break;
+      }
+      frequencies[lengthIterator].assign(frequencyPairs, frequencyPairs + numFrequencies);
+      //Older files may leave counts out so the table is sized by the largest count stored
+      for (pairIterator = 0; pairIterator < numProbabilities; ++pairIterator) {
+        if (probabilityPairs[pairIterator].count >= (int) probabilities[lengthIterator].size()) {
+          probabilities[lengthIterator].resize(probabilityPairs[pairIterator].count + 1, 0);
+        }
+        probabilities[lengthIterator][probabilityPairs[pairIterator].count] = probabilityPairs[pairIterator].probability;
+      }
+    }
   }
 
   //Default constructor and destructor
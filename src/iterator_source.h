@@ -0,0 +1,51 @@
+/**************************************************************
+* A source of tokens taken from a range of iterators, such as
+* a vector or an istream_iterator over a pipe
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_ITERATOR_SOURCE
+#define _H_ITERATOR_SOURCE
+
+#include "lexicon.t.h"
+#include "tokenSource.i.h"
+
+namespace nlp {
+
+  template <typename Type, typename Iterator> class IteratorSource : public TokenSource<Type> {
+  private:
+    /* The next token to read */
+    Iterator current;
+
+    /* The position after the last token */
+    Iterator last;
+
+  public:
+    /*******************
+    * Creates a new source reading the tokens between two iterators
+    * @param first_in first token to read
+    * @param last_in  position after the last token to read
+    *******************/
+    IteratorSource(Iterator first_in, Iterator last_in);
+
+    //Destructor
+    ~IteratorSource();
+
+    /******************
+    * Reads the next token from the source as its identifier in a lexicon
+    * @param  lexicon_in  lexicon to add new tokens to
+    * @param  location_in location to store the identifier
+    * @return 0 there are no tokens left
+    * @return 1 a token was read
+    ******************/
+    int nextId(Lexicon<Type> * lexicon_in, TokenId * location_in);
+  };
+
+};
+
+#endif
@@ -0,0 +1,33 @@
+//A source of tokens taken from a range of iterators
+
+#ifndef _T_ITERATOR_SOURCE
+#define _T_ITERATOR_SOURCE
+
+#include "iterator_source.h"
+
+namespace nlp {
+
+  //Reads the next token from the source as its identifier in a lexicon
+  template <typename Type, typename Iterator> int IteratorSource<Type, Iterator>::nextId(Lexicon<Type> * lexicon_in, TokenId * location_in) {
+    Type token;
+
+    if (current == last) {
+      return 0;
+    }
+    token = *current;
+    ++current;
+    *location_in = lexicon_in->addToken(&token);
+
+    return 1;
+  }
+
+  //Creates a new source reading the tokens between two iterators
+  template <typename Type, typename Iterator> IteratorSource<Type, Iterator>::IteratorSource(Iterator first_in, Iterator last_in)
+    :current(first_in), last(last_in) {}
+
+  //Destructor
+  template <typename Type, typename Iterator> IteratorSource<Type, Iterator>::~IteratorSource() {}
+
+};
+
+#endif
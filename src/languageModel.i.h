@@ -4,13 +4,15 @@
 * Created By: Nick DelBen
 * Created On: March 8, 2015
 *
-* Last Edited: March 8, 2015
-*   - Created initially
+* Last Edited: October 18, 2026
+*   - Added advancing a scorer state one token at a time
 **************************************************************/
 
 #ifndef _I_LANGUAGEMODEL
 #define _I_LANGUAGEMODEL
 
+#include "scorer_state.h"
+
 namespace nlp {
 
   template <typename Type> class LanguageModel {
@@ -37,6 +39,15 @@ namespace nlp {
     * @return prabability of sentence occurance
     ******************/
     virtual double logSentenceProbability(int length_in, std::vector<Type> * sentence_in) = 0;
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  token_in  token to score
+    * @return natural log of the probability of the token
+    ******************/
+    virtual double advanceState(int length_in, ScorerState * state_in, Type * token_in) = 0;
   };
 
 };
@@ -0,0 +1,104 @@
+/**************************************************************
+* Maps the tokens of a document to dense integer identifiers
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_LEXICON
+#define _H_LEXICON
+
+#include <vector>        //std::vector
+#include <unordered_map> //std::unordered_map
+
+#define UNKNOWN_TOKEN_ID 0xFFFFFFFFu
+
+namespace nlp {
+
+  /* Identifier assigned to each distinct token of a document */
+  typedef unsigned int TokenId;
+
+  template <typename Type> class Lexicon {
+  private:
+    /* Identifier of each token that has been added */
+    std::unordered_map<Type, TokenId> ids;
+
+    /* Tokens that have been added, indexed by their identifier */
+    std::vector<Type> words;
+
+  public:
+    //Default constructor and destructor
+    Lexicon();
+    ~Lexicon();
+
+    /*******************
+    * Finds the identifier of a token, adding the token if it has not been seen
+    * @param  token_in token to find the identifier of
+    * @return identifier of the token
+    *******************/
+    TokenId addToken(Type * token_in);
+
+    /*******************
+    * Finds the identifier of a token without adding it
+    * @param  token_in token to find the identifier of
+    * @return identifier of the token
+    * @return UNKNOWN_TOKEN_ID token has not been added
+    *******************/
+    TokenId findToken(const Type * token_in);
+
+    /*******************
+    * Finds the token with the specified identifier
+    * @param  id_in identifier of the token
+    * @return the token with the specified identifier
+    *******************/
+    Type * getToken(TokenId id_in);
+
+    /*******************
+    * Finds the identifiers of a list of tokens, adding any that have not been seen
+    * @param  tokens_in   tokens to find identifiers of
+    * @param  location_in location to append the identifiers to
+    * @return 0 success
+    *******************/
+    int addTokens(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in);
+
+    /*******************
+    * Finds the identifiers of a list of tokens without adding any
+    * @param  tokens_in   tokens to find identifiers of
+    * @param  location_in location to store the identifiers
+    * @return 0  success
+    * @return -1 at least one token has not been added
+    *******************/
+    int findTokens(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in);
+
+    /*******************
+    * Finds the identifiers of a list of tokens without adding any or allocating
+    * @param  tokens_in   first of the tokens to find identifiers of
+    * @param  length_in   number of tokens in the list
+    * @param  location_in location to store length_in identifiers
+    * @return 0  success
+    * @return -1 at least one token has not been added
+    *******************/
+    int findTokens(const Type * tokens_in, int length_in, TokenId * location_in);
+
+    /*******************
+    * Finds the tokens of a list of identifiers
+    * @param  ids_in      identifiers to find the tokens of
+    * @param  length_in   number of identifiers in the list
+    * @param  location_in location to store the tokens
+    * @return 0 success
+    *******************/
+    int getTokens(const TokenId * ids_in, int length_in, std::vector<Type> * location_in);
+
+    /*******************
+    * Finds the number of distinct tokens that have been added
+    * @return number of distinct tokens
+    *******************/
+    int size();
+  };
+
+};
+
+#endif
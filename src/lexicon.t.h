@@ -0,0 +1,110 @@
+//Maps the tokens of a document to dense integer identifiers
+
+#ifndef _T_LEXICON
+#define _T_LEXICON
+
+#include "lexicon.h"
+
+namespace nlp {
+
+  //Finds the identifier of a token, adding the token if it has not been seen
+  template <typename Type> TokenId Lexicon<Type>::addToken(Type * token_in) {
+    auto result = ids.find(*token_in);
+
+    //If the token has been seen before reuse its identifier
+    if (result != ids.end()) {
+      return result->second;
+    }
+
+    //New tokens are given the next free identifier
+    ids[*token_in] = (TokenId) words.size();
+    words.push_back(*token_in);
+
+    return (TokenId) words.size() - 1;
+  }
+
+  //Finds the identifier of a token without adding it
+  template <typename Type> TokenId Lexicon<Type>::findToken(const Type * token_in) {
+    auto result = ids.find(*token_in);
+
+    if (result == ids.end()) {
+      return UNKNOWN_TOKEN_ID;
+    }
+
+    return result->second;
+  }
+
+  //Finds the token with the specified identifier
+  template <typename Type> Type * Lexicon<Type>::getToken(TokenId id_in) {
+    return &words[id_in];
+  }
+
+  //Finds the identifiers of a list of tokens, adding any that have not been seen
+  template <typename Type> int Lexicon<Type>::addTokens(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in) {
+    int tokenIterator;
+
+    location_in->reserve(location_in->size() + tokens_in->size());
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      location_in->push_back(addToken(&(*tokens_in)[tokenIterator]));
+    }
+
+    return 0;
+  }
+
+  //Finds the identifiers of a list of tokens without adding any
+  template <typename Type> int Lexicon<Type>::findTokens(std::vector<Type> * tokens_in, std::vector<TokenId> * location_in) {
+    int tokenIterator;
+    TokenId current;
+
+    location_in->clear();
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      current = findToken(&(*tokens_in)[tokenIterator]);
+      //A token that was never added can not be part of anything stored
+      if (current == UNKNOWN_TOKEN_ID) {
+        return -1;
+      }
+      location_in->push_back(current);
+    }
+
+    return 0;
+  }
+
+  //Finds the identifiers of a list of tokens without adding any or allocating
+  template <typename Type> int Lexicon<Type>::findTokens(const Type * tokens_in, int length_in, TokenId * location_in) {
+    int tokenIterator;
+
+    for (tokenIterator = 0; tokenIterator < length_in; ++tokenIterator) {
+      location_in[tokenIterator] = findToken(&tokens_in[tokenIterator]);
+      //A token that was never added can not be part of anything stored
+      if (location_in[tokenIterator] == UNKNOWN_TOKEN_ID) {
+        return -1;
+      }
+    }
+
+    return 0;
+  }
+
+  //Finds the tokens of a list of identifiers
+  template <typename Type> int Lexicon<Type>::getTokens(const TokenId * ids_in, int length_in, std::vector<Type> * location_in) {
+    int idIterator;
+
+    location_in->clear();
+    for (idIterator = 0; idIterator < length_in; ++idIterator) {
+      location_in->push_back(words[ids_in[idIterator]]);
+    }
+
+    return 0;
+  }
+
+  //Finds the number of distinct tokens that have been added
+  template <typename Type> int Lexicon<Type>::size() {
+    return words.size();
+  }
+
+  //Default constructor and destructor
+  template <typename Type> Lexicon<Type>::Lexicon() {}
+  template <typename Type> Lexicon<Type>::~Lexicon() {}
+
+};
+
+#endif
@@ -0,0 +1,162 @@
+//A locality sensitive hashing index of MinHash signatures that finds near duplicate texts without comparing every pair
+
+#include <algorithm>     //std::sort()   std::unique()
+#include <unordered_set> //std::unordered_set
+
+#include "lsh_index.h"
+
+namespace nlp {
+
+  //Finds the hash of one band of a signature
+  unsigned long long LshIndex::hashBand(const unsigned int * signature_in, int band_in) {
+    unsigned long long result;
+    int rowIterator;
+
+    //The band number is mixed in so equal values in different bands do not share a bucket by accident
+    result = 0x9E3779B97F4A7C15ull * (unsigned long long) (band_in + 1);
+    for (rowIterator = band_in * numRows; rowIterator < (band_in + 1) * numRows; ++rowIterator) {
+      result = (result ^ signature_in[rowIterator]) * 0xFF51AFD7ED558CCDull;
+      result ^= result >> 32;
+    }
+
+    return result;
+  }
+
+  //Finds the fraction of equal values in two signatures viewed in place
+  double LshIndex::compare(const unsigned int * first_in, const unsigned int * second_in, size_t length_in) {
+    size_t valueIterator;
+    size_t numEqual;
+
+    if (length_in == 0) {
+      return 0;
+    }
+    numEqual = 0;
+    for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+      numEqual += first_in[valueIterator] == second_in[valueIterator];
+    }
+
+    return (double) numEqual / length_in;
+  }
+
+  //Estimates the Jaccard similarity of two sets from their signatures
+  double LshIndex::similarity(const std::vector<unsigned int> * first_in, const std::vector<unsigned int> * second_in) {
+    return compare(first_in->data(), second_in->data(), first_in->size() < second_in->size() ? first_in->size() : second_in->size());
+  }
+
+  //Adds a text's signature to the index
+  int LshIndex::add(std::vector<unsigned int> * signature_in) {
+    int bandIterator;
+    int result;
+
+    if ((int) signature_in->size() < numBands * numRows) {
+      return -1;
+    }
+
+    result = size();
+    //Only the values the bands use are kept for estimating similarity
+    signatures.insert(signatures.end(), signature_in->begin(), signature_in->begin() + numBands * numRows);
+    for (bandIterator = 0; bandIterator < numBands; ++bandIterator) {
+      buckets[bandIterator][hashBand(signature_in->data(), bandIterator)].push_back(result);
+    }
+
+    return result;
+  }
+
+  //Finds the texts sharing at least one band with a signature
+  int LshIndex::findCandidates(std::vector<unsigned int> * signature_in, std::vector<int> * location_in) {
+    int bandIterator;
+
+    location_in->clear();
+    if ((int) signature_in->size() < numBands * numRows) {
+      return -1;
+    }
+
+    for (bandIterator = 0; bandIterator < numBands; ++bandIterator) {
+      auto bucket = buckets[bandIterator].find(hashBand(signature_in->data(), bandIterator));
+      if (bucket != buckets[bandIterator].end()) {
+        location_in->insert(location_in->end(), bucket->second.begin(), bucket->second.end());
+      }
+    }
+    std::sort(location_in->begin(), location_in->end());
+    location_in->erase(std::unique(location_in->begin(), location_in->end()), location_in->end());
+
+    return 0;
+  }
+
+  //Finds the candidates of a signature whose estimated similarity is at least a threshold
+  int LshIndex::findSimilar(std::vector<unsigned int> * signature_in, double threshold_in, std::vector<std::pair<int, double>> * location_in) {
+    std::vector<int> candidates;
+    size_t candidateIterator;
+    size_t length;
+    double current;
+
+    location_in->clear();
+    if (findCandidates(signature_in, &candidates) == -1) {
+      return -1;
+    }
+
+    length = numBands * numRows;
+    for (candidateIterator = 0; candidateIterator < candidates.size(); ++candidateIterator) {
+      current = compare(signature_in->data(), &signatures[candidates[candidateIterator] * length], length);
+      if (current >= threshold_in) {
+        location_in->push_back(std::make_pair(candidates[candidateIterator], current));
+      }
+    }
+    std::stable_sort(location_in->begin(), location_in->end(), [](const std::pair<int, double> & first_in, const std::pair<int, double> & second_in) {
+      return first_in.second > second_in.second;
+    });
+
+    return 0;
+  }
+
+  //Finds every pair of texts in the index that share a band and whose estimated similarity is at least a threshold
+  int LshIndex::findDuplicates(double threshold_in, std::vector<std::pair<int, int>> * location_in) {
+    std::unordered_set<unsigned long long> checked;
+    size_t length;
+    int bandIterator;
+
+    location_in->clear();
+    length = numBands * numRows;
+    for (bandIterator = 0; bandIterator < numBands; ++bandIterator) {
+      for (auto bucket = buckets[bandIterator].begin(); bucket != buckets[bandIterator].end(); ++bucket) {
+        std::vector<int> & members = bucket->second;
+        size_t firstIterator;
+        size_t secondIterator;
+
+        for (firstIterator = 0; firstIterator < members.size(); ++firstIterator) {
+          for (secondIterator = firstIterator + 1; secondIterator < members.size(); ++secondIterator) {
+            //Pairs sharing several bands are only compared once
+            if (! checked.insert(((unsigned long long) members[firstIterator] << 32) | (unsigned int) members[secondIterator]).second) {
+              continue;
+            }
+            if (compare(&signatures[members[firstIterator] * length], &signatures[members[secondIterator] * length], length) >= threshold_in) {
+              location_in->push_back(std::make_pair(members[firstIterator], members[secondIterator]));
+            }
+          }
+        }
+      }
+    }
+    std::sort(location_in->begin(), location_in->end());
+
+    return 0;
+  }
+
+  //Finds the number of texts added to the index
+  int LshIndex::size() {
+    return numBands * numRows == 0 ? 0 : (int) (signatures.size() / (numBands * numRows));
+  }
+
+  //Creates an empty index
+  LshIndex::LshIndex(int numBands_in, int numRows_in) {
+    numBands = numBands_in;
+    numRows = numRows_in;
+    buckets.resize(numBands);
+  }
+
+  //Default constructor and destructor
+  LshIndex::LshIndex() {
+    numBands = 0;
+    numRows = 0;
+  }
+  LshIndex::~LshIndex() {}
+};
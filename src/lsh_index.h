@@ -0,0 +1,118 @@
+/**************************************************************
+* A locality sensitive hashing index of MinHash signatures that
+* finds near duplicate texts without comparing every pair
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_LSH_INDEX
+#define _H_LSH_INDEX
+
+#include <vector>        //std::vector
+#include <utility>       //std::pair
+#include <unordered_map> //std::unordered_map
+#include <cstddef>       //size_t
+
+namespace nlp {
+
+  class LshIndex {
+  private:
+    /* Number of bands each signature is split into */
+    int numBands;
+
+    /* Number of signature values in each band */
+    int numRows;
+
+    /* Signatures of every text added, one after another */
+    std::vector<unsigned int> signatures;
+
+    /* Identifiers of the texts in each bucket of each band, keyed by the hash of the band's values */
+    std::vector<std::unordered_map<unsigned long long, std::vector<int>>> buckets;
+
+    /*******************
+    * Finds the hash of one band of a signature
+    * @param  signature_in first value of the signature
+    * @param  band_in      band to hash
+    * @return hash of the band's values
+    *******************/
+    unsigned long long hashBand(const unsigned int * signature_in, int band_in);
+
+    /*******************
+    * Finds the fraction of equal values in two signatures viewed in place
+    * @param  first_in  first value of the first signature
+    * @param  second_in first value of the second signature
+    * @param  length_in number of values to compare
+    * @return fraction of the values that are equal
+    *******************/
+    static double compare(const unsigned int * first_in, const unsigned int * second_in, size_t length_in);
+
+  public:
+    /*******************
+    * Creates an empty index. Two texts become candidates when every value of any one band of their
+    * signatures is equal, which happens with probability 1 - (1 - s^rows)^bands at Jaccard similarity s
+    * @param numBands_in number of bands
+    * @param numRows_in  number of values in each band, bands times rows can not be more than the signature's length
+    *******************/
+    LshIndex(int numBands_in, int numRows_in);
+
+    //Default constructor and destructor
+    LshIndex();
+    ~LshIndex();
+
+    /*******************
+    * Estimates the Jaccard similarity of two sets from their signatures as the fraction of values they share
+    * @param  first_in  signature of the first set
+    * @param  second_in signature of the second set, made by the same hasher
+    * @return estimated similarity between 0 and 1
+    *******************/
+    static double similarity(const std::vector<unsigned int> * first_in, const std::vector<unsigned int> * second_in);
+
+    /*******************
+    * Adds a text's signature to the index
+    * @param  signature_in signature of the text
+    * @return identifier of the text, the number of texts added before it
+    * @return -1 the signature is shorter than bands times rows
+    *******************/
+    int add(std::vector<unsigned int> * signature_in);
+
+    /*******************
+    * Finds the texts sharing at least one band with a signature
+    * @param  signature_in signature to find candidates for
+    * @param  location_in  location to store the identifiers of the texts, sorted
+    * @return 0  success
+    * @return -1 the signature is shorter than bands times rows
+    *******************/
+    int findCandidates(std::vector<unsigned int> * signature_in, std::vector<int> * location_in);
+
+    /*******************
+    * Finds the candidates of a signature whose estimated similarity is at least a threshold
+    * @param  signature_in signature to find similar texts for
+    * @param  threshold_in least estimated similarity to keep
+    * @param  location_in  location to store (text, estimated similarity) pairs, most similar first
+    * @return 0  success
+    * @return -1 the signature is shorter than bands times rows
+    *******************/
+    int findSimilar(std::vector<unsigned int> * signature_in, double threshold_in, std::vector<std::pair<int, double>> * location_in);
+
+    /*******************
+    * Finds every pair of texts in the index that share a band and whose estimated similarity is at least a threshold
+    * @param  threshold_in least estimated similarity to keep
+    * @param  location_in  location to store the pairs, the smaller identifier first, sorted
+    * @return 0 success
+    *******************/
+    int findDuplicates(double threshold_in, std::vector<std::pair<int, int>> * location_in);
+
+    /*******************
+    * Finds the number of texts added to the index
+    * @return number of texts
+    *******************/
+    int size();
+  };
+
+};
+
+#endif
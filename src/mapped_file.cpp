@@ -0,0 +1,86 @@
+//A file mapped read only into memory
+
+#include <sys/mman.h> //mmap()   munmap()   madvise()
+#include <sys/stat.h> //fstat()
+#include <fcntl.h>    //open()
+#include <unistd.h>   //close()
+
+#include "mapped_file.h"
+
+namespace nlp {
+
+  //Maps a file into memory
+  int MappedFile::open(std::string fileName_in, int sequential_in) {
+    struct stat status;
+    int descriptor;
+    void * mapping;
+
+    close();
+
+    descriptor = ::open(fileName_in.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+      return -1;
+    }
+    if (fstat(descriptor, &status) != 0) {
+      ::close(descriptor);
+      return -1;
+    }
+
+    //An empty file can not be mapped
+    mapping = (void *) "";
+    if (status.st_size > 0) {
+      //A shared mapping lets every process reading the file use the same pages
+      mapping = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(descriptor);
+        return -1;
+      }
+      if (sequential_in > 0) {
+        madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+      }
+    }
+    //The mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+
+    data = (const char *) mapping;
+    size = status.st_size;
+
+    return 0;
+  }
+
+  //Unmaps the current file
+  int MappedFile::close() {
+    if (data != NULL && size > 0) {
+      munmap((void *) data, size);
+    }
+    data = NULL;
+    size = 0;
+
+    return 0;
+  }
+
+  //Checks if a file is mapped
+  int MappedFile::isOpen() {
+    return data != NULL ? 1 : 0;
+  }
+
+  //Finds the first byte of the mapped file
+  const char * MappedFile::getData() {
+    return data;
+  }
+
+  //Finds the number of bytes in the mapped file
+  size_t MappedFile::getSize() {
+    return size;
+  }
+
+  //Default constructor and destructor
+  MappedFile::MappedFile() {
+    data = NULL;
+    size = 0;
+  }
+  MappedFile::~MappedFile() {
+    close();
+  }
+
+};
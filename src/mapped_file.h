@@ -0,0 +1,72 @@
+/**************************************************************
+* A file mapped read only into memory
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_MAPPED_FILE
+#define _H_MAPPED_FILE
+
+#include <string> //std::string
+
+namespace nlp {
+
+  class MappedFile {
+  private:
+    /* The mapped contents of the file */
+    const char * data;
+
+    /* Number of bytes in the file */
+    size_t size;
+
+  public:
+    //Default constructor and destructor
+    MappedFile();
+    ~MappedFile();
+
+    //A mapped file owns its mapping so it can not be copied
+    MappedFile(const MappedFile & file_in) = delete;
+    MappedFile & operator=(const MappedFile & file_in) = delete;
+
+    /*******************
+    * Maps a file into memory, an empty file is open but has no bytes
+    * @param  fileName_in   name of the file to map
+    * @param  sequential_in if this is >0 the file is expected to be read from front to back
+    * @return 0  success
+    * @return -1 file could not be opened
+    *******************/
+    int open(std::string fileName_in, int sequential_in);
+
+    /*******************
+    * Unmaps the current file
+    * @return 0 success
+    *******************/
+    int close();
+
+    /*******************
+    * Checks if a file is mapped
+    * @return 0 no file is mapped
+    * @return 1 a file is mapped
+    *******************/
+    int isOpen();
+
+    /*******************
+    * Finds the first byte of the mapped file
+    * @return the first byte of the file
+    *******************/
+    const char * getData();
+
+    /*******************
+    * Finds the number of bytes in the mapped file
+    * @return number of bytes in the file
+    *******************/
+    size_t getSize();
+  };
+
+};
+
+#endif
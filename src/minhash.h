@@ -0,0 +1,89 @@
+/**************************************************************
+* Computes MinHash signatures of the sets of ngrams of texts
+* so their Jaccard similarity can be estimated from the signatures
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_MINHASH
+#define _H_MINHASH
+
+#include <vector>     //std::vector
+#include <functional> //std::hash
+
+namespace nlp {
+
+  template <typename Type> class MinHasher {
+  private:
+    /* Odd multiplier of each of the hash functions the signature keeps the minimum of */
+    std::vector<unsigned long long> multipliers;
+
+    /* Value added by each of the hash functions */
+    std::vector<unsigned long long> addends;
+
+  public:
+    /*******************
+    * Creates a hasher making signatures of the specified number of values. Signatures can only be
+    * compared if they were made by hashers with the same number of values and seed
+    * @param numHashes_in number of values in each signature
+    * @param seed_in      seed the hash functions are derived from
+    *******************/
+    MinHasher(int numHashes_in, unsigned long long seed_in);
+
+    //Default constructor and destructor
+    MinHasher();
+    ~MinHasher();
+
+    /*******************
+    * Finds the hash code of a token, which is the same in every document
+    * @param  token_in token to hash
+    * @return hash code of the token
+    *******************/
+    static unsigned long long hashToken(const Type * token_in);
+
+    /*******************
+    * Finds the hash code of an ngram from the hash codes of its tokens
+    * @param  tokenHashes_in hash code of each token of the ngram
+    * @param  length_in      number of tokens in the ngram
+    * @return hash code of the ngram
+    *******************/
+    static unsigned long long hashNgram(const unsigned long long * tokenHashes_in, int length_in);
+
+    /*******************
+    * Empties a signature so ngrams can be added to it
+    * @param  location_in signature to empty
+    * @return 0 success
+    *******************/
+    int resetSignature(std::vector<unsigned int> * location_in);
+
+    /*******************
+    * Adds the hash code of an ngram to a signature, adding an ngram more than once changes nothing
+    * @param  hash_in     hash code of the ngram from hashNgram
+    * @param  location_in signature emptied by resetSignature
+    * @return 0 success
+    *******************/
+    int addHash(unsigned long long hash_in, std::vector<unsigned int> * location_in);
+
+    /*******************
+    * Computes the signature of the set of ngrams of a length in a list of tokens, such as a sentence
+    * @param  length_in   length of the ngrams
+    * @param  tokens_in   tokens to find the ngrams of
+    * @param  location_in location to store the signature
+    * @return 0 success
+    *******************/
+    int signature(int length_in, std::vector<Type> * tokens_in, std::vector<unsigned int> * location_in);
+
+    /*******************
+    * Finds the number of values in each signature
+    * @return number of values
+    *******************/
+    int size();
+  };
+
+};
+
+#endif
@@ -0,0 +1,108 @@
+//Computes MinHash signatures of the sets of ngrams of texts so their Jaccard similarity can be estimated from the signatures
+
+#ifndef _T_MINHASH
+#define _T_MINHASH
+
+#include "minhash.h"
+
+namespace nlp {
+
+  //Finds the hash code of a token
+  template <typename Type> unsigned long long MinHasher<Type>::hashToken(const Type * token_in) {
+    unsigned long long result;
+
+    //The standard hash of many types is the value itself so it is mixed before use
+    result = (unsigned long long) std::hash<Type>()(*token_in);
+    result ^= result >> 33;
+    result *= 0xFF51AFD7ED558CCDull;
+    result ^= result >> 33;
+
+    return result;
+  }
+
+  //Finds the hash code of an ngram from the hash codes of its tokens
+  template <typename Type> unsigned long long MinHasher<Type>::hashNgram(const unsigned long long * tokenHashes_in, int length_in) {
+    unsigned long long result;
+    int tokenIterator;
+
+    result = 0x9E3779B97F4A7C15ull;
+    for (tokenIterator = 0; tokenIterator < length_in; ++tokenIterator) {
+      result = (result ^ tokenHashes_in[tokenIterator]) * 0xC4CEB9FE1A85EC53ull;
+      result ^= result >> 29;
+    }
+
+    return result;
+  }
+
+  //Empties a signature so ngrams can be added to it
+  template <typename Type> int MinHasher<Type>::resetSignature(std::vector<unsigned int> * location_in) {
+    location_in->assign(multipliers.size(), 0xFFFFFFFFu);
+    return 0;
+  }
+
+  //Adds the hash code of an ngram to a signature
+  template <typename Type> int MinHasher<Type>::addHash(unsigned long long hash_in, std::vector<unsigned int> * location_in) {
+    unsigned int * values;
+    unsigned int current;
+    int hashIterator;
+
+    //Each hash function is a multiply and add of the already mixed hash code, keeping the high bits
+    values = location_in->data();
+    for (hashIterator = 0; hashIterator < (int) multipliers.size(); ++hashIterator) {
+      current = (unsigned int) ((multipliers[hashIterator] * hash_in + addends[hashIterator]) >> 32);
+      values[hashIterator] = current < values[hashIterator] ? current : values[hashIterator];
+    }
+
+    return 0;
+  }
+
+  //Computes the signature of the set of ngrams of a length in a list of tokens
+  template <typename Type> int MinHasher<Type>::signature(int length_in, std::vector<Type> * tokens_in, std::vector<unsigned int> * location_in) {
+    std::vector<unsigned long long> tokenHashes;
+    int tokenIterator;
+
+    resetSignature(location_in);
+    tokenHashes.resize(tokens_in->size());
+    for (tokenIterator = 0; tokenIterator < (int) tokens_in->size(); ++tokenIterator) {
+      tokenHashes[tokenIterator] = hashToken(&(*tokens_in)[tokenIterator]);
+    }
+    for (tokenIterator = 0; tokenIterator + length_in <= (int) tokens_in->size(); ++tokenIterator) {
+      addHash(hashNgram(&tokenHashes[tokenIterator], length_in), location_in);
+    }
+
+    return 0;
+  }
+
+  //Finds the number of values in each signature
+  template <typename Type> int MinHasher<Type>::size() {
+    return (int) multipliers.size();
+  }
+
+  //Creates a hasher making signatures of the specified number of values
+  template <typename Type> MinHasher<Type>::MinHasher(int numHashes_in, unsigned long long seed_in) {
+    unsigned long long state;
+    int hashIterator;
+
+    //Splitmix steps turn the one seed into the constants of every hash function
+    state = seed_in;
+    for (hashIterator = 0; hashIterator < numHashes_in; ++hashIterator) {
+      unsigned long long values[2];
+      int valueIterator;
+      for (valueIterator = 0; valueIterator < 2; ++valueIterator) {
+        state += 0x9E3779B97F4A7C15ull;
+        values[valueIterator] = state;
+        values[valueIterator] = (values[valueIterator] ^ (values[valueIterator] >> 30)) * 0xBF58476D1CE4E5B9ull;
+        values[valueIterator] = (values[valueIterator] ^ (values[valueIterator] >> 27)) * 0x94D049BB133111EBull;
+        values[valueIterator] ^= values[valueIterator] >> 31;
+      }
+      multipliers.push_back(values[0] | 1);
+      addends.push_back(values[1]);
+    }
+  }
+
+  //Default constructor and destructor
+  template <typename Type> MinHasher<Type>::MinHasher() {}
+  template <typename Type> MinHasher<Type>::~MinHasher() {}
+};
+
+#endif
@@ -5,8 +5,8 @@
 * Created By: Nick DelBen
 * Created On: March 4, 2015
 *
-* Last Edited: March 6, 2015
-*   - Modified generateSentence to allow proper sentence prefixes
+* Last Edited: October 18, 2026
+*   - Added quantizing the probabilities of the stored ngrams
 **************************************************************/
 
 #ifndef _H_ML_DOCUMENT
@@ -14,15 +14,120 @@
 
 #include <time.h>  //time()
 #include <cmath>   //log()
+#include <cstdio>  //fopen()   fwrite()
+#include <thread>  //std::thread
+#include <atomic>  //std::atomic
 
 #include "document.t.h"
+#include "alias_table.h"
 #include "languageModel.i.h"
 
 #define SENTENCE_PREFIX_NGRAM_LENGTH 2
+#define GENERATE_BLOCK_LENGTH 16
+#define GENERATE_ROUND_LENGTH 4096
 
 namespace nlp {
 
   template <typename Type> class MLDocument : public Document<Type>, public LanguageModel<Type> {
+  private:
+    /* Tokens that follow a context, their counts and a table drawing from them by count */
+    struct SuccessorList {
+      std::vector<TokenId> successors;
+      std::vector<double> weights;
+      AliasTable table;
+    };
+
+    /* Successors of every context, the index is the length of the context. The contexts of a length are
+       gathered the first time a sentence needs them and each table is built the first time it is drawn from */
+    std::vector<std::vector<SuccessorList>> successorLists;
+
+    /* Index in successorLists of every context, the index is the length of the context */
+    std::vector<NgramTable<int>> successorIndexes;
+
+    /* Generator used to draw the tokens of generated sentences */
+    RandomGenerator generator;
+
+    /******************
+    * Gathers the tokens that follow every context of a length from the ngrams one token longer, if they were not already
+    * @param  length_in length of the contexts, 0 to gather every single token
+    * @return 0  success
+    * @return -1 the ngrams one token longer than the contexts have not been read or are counted in a sketch
+    ******************/
+    int gatherSuccessors(int length_in);
+
+    /******************
+    * Draws a token to follow a context with a chance proportional to the count of the ngram they make
+    * @param  context_in   identifiers of the context
+    * @param  length_in    number of identifiers in the context
+    * @param  generator_in generator to draw the token with
+    * @param  location_in  location to store the identifier of the drawn token
+    * @return 0  success
+    * @return -1 no token follows the context
+    ******************/
+    int sampleSuccessor(const TokenId * context_in, int length_in, RandomGenerator * generator_in, TokenId * location_in);
+
+    /******************
+    * Generates the identifiers of a random sentence, ending with the end of sentence token
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the sentence starts after an end of sentence token, which is stored first
+    * @param  endId_in       identifier of the end of sentence token
+    * @param  generator_in   generator to draw the tokens with
+    * @param  location_in    location to store the identifiers
+    * @return 0  success
+    * @return -1 the document has no tokens
+    ******************/
+    int generateIds(int length_in, int sentencePrefix, TokenId endId_in, RandomGenerator * generator_in, std::vector<TokenId> * location_in);
+
+    /******************
+    * Reads the ngrams and builds every table that generating sentences with a context length needs, so the
+    * sentences can then be generated by many threads at once without changing the document
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the tables of the tokens that start a sentence are built too
+    * @param  endId_out      location to store the identifier of the end of sentence token
+    * @return 0  success
+    * @return -1 the document has no sentence ends or no tokens
+    ******************/
+    int prepareGeneration(int length_in, int sentencePrefix, TokenId * endId_out);
+
+    /******************
+    * Generates blocks of sentences until none are left. Every sentence draws from its own generator
+    * seeded from the seed and the sentence's number, so the sentences do not depend on the threads
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the sentences start like the sentences of the document
+    * @param  endId_in       identifier of the end of sentence token
+    * @param  seed_in        seed that every sentence's generator is derived from
+    * @param  first_in       number of the first sentence to generate
+    * @param  next_in        counter of the next block to generate shared by the threads
+    * @param  ids_out        location to store the identifiers of each sentence, or NULL to store the tokens
+    * @param  tokens_out     location to store the tokens of each sentence when ids_out is NULL
+    * @return 0 success
+    ******************/
+    int generateBlocks(int length_in, int sentencePrefix, TokenId endId_in, unsigned long long seed_in, int first_in,
+      std::atomic<int> * next_in, std::vector<std::vector<TokenId>> * ids_out, std::vector<std::vector<Type>> * tokens_out);
+
+    /******************
+    * Runs generateBlocks on each thread and waits for them to finish. The outputs are already sized to
+    * the number of sentences to generate
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the sentences start like the sentences of the document
+    * @param  endId_in       identifier of the end of sentence token
+    * @param  seed_in        seed that every sentence's generator is derived from
+    * @param  first_in       number of the first sentence to generate
+    * @param  numThreads_in  number of threads to generate with
+    * @param  ids_out        location to store the identifiers of each sentence, or NULL to store the tokens
+    * @param  tokens_out     location to store the tokens of each sentence when ids_out is NULL
+    * @return 0 success
+    ******************/
+    int generateAll(int length_in, int sentencePrefix, TokenId endId_in, unsigned long long seed_in, int first_in,
+      int numThreads_in, std::vector<std::vector<TokenId>> * ids_out, std::vector<std::vector<Type>> * tokens_out);
+
+    /******************
+    * Computes the probability of the token stored just after a state's context given the context
+    * @param  state_in state holding the context and the token
+    * @return probability of the token
+    ******************/
+    double nextProbability(ScorerState * state_in);
+
   public:
     /*******************
     * Creates a new instance of MLDocument finding all the ngrams 
@@ -46,6 +151,49 @@ namespace nlp {
     * @param gramLenghts_in the lengths to construct the dictionaries from
     *******************/
     MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in);
+    /*******************
+    * Creates a new instance of MLDocument finding all the ngrams of the sizes specified in the
+    * input vector, counted on several threads
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param numThreads_in  number of threads to count with
+    *******************/
+    MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in);
+    /*******************
+    * Creates a new instance of MLDocument from tokens that have already been given identifiers
+    * @param lexicon_in     lexicon the identifiers were taken from
+    * @param tokens_in      identifiers of the tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    *******************/
+    MLDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in);
+    /*******************
+    * Creates a new instance of MLDocument by counting ngrams as the tokens are read from a source
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param keepTokens_in  if this is >0 the tokens are also stored so more lengths can be read later
+    *******************/
+    MLDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in);
+    /*******************
+    * Creates a new instance of MLDocument that counts the longer lengths in count-min sketches as
+    * Document does, so their probabilities come from estimated counts
+    * @param tokens_in      tokens to create the document from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in);
+    /*******************
+    * Creates a new instance of MLDocument that counts the longer lengths in count-min sketches as
+    * the tokens are read from a source, which is not kept
+    * @param source_in      source to read the tokens from
+    * @param gramLenghts_in the lengths to construct the dictionaries from
+    * @param options_in     size of the sketches and which ngrams are kept exactly
+    *******************/
+    MLDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in);
+    /*******************
+    * Creates a new instance of MLDocument that queries its counts directly from a mapped model file
+    * @param model_in model file to query the counts from
+    *******************/
+    MLDocument(ModelFile * model_in);
 
     //Default constructor and destructor
     MLDocument();
@@ -74,6 +222,17 @@ namespace nlp {
     ******************/
     double probabilityGiven(std::vector<Type> * given_in, Type * ngram_in);
 
+    /******************
+    * Computes the probability of an ngram occuring given another ngram, both viewed in place, without
+    * allocating when together they hold up to NGRAM_VIEW_LENGTH tokens
+    * @param  given_in        first token of the ngram given to have occured already
+    * @param  givenLength_in  number of tokens given
+    * @param  ngram_in        first token of the ngram to find the probability of
+    * @param  ngramLength_in  number of tokens in the ngram
+    * @return prabability of ngram occurance
+    ******************/
+    double probabilityGiven(const Type * given_in, int givenLength_in, const Type * ngram_in, int ngramLength_in);
+
     /******************
     * Computes the probability of a sentence occuring based
     * @param  length_in   length of ngrams to check
@@ -90,13 +249,32 @@ namespace nlp {
     ******************/
     double logSentenceProbability(int length_in, std::vector<Type> * sentence_in);
 
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  token_in  token to score
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, Type * token_in);
+
+    /******************
+    * Scores the next token of a sentence given the tokens held by a state, then adds the token to the state
+    * @param  length_in length of ngrams to check
+    * @param  state_in  state holding the tokens before this one, emptied by resetState at the start of a sentence
+    * @param  id_in     identifier of the token to score in the lexicon of the document
+    * @return natural log of the probability of the token
+    ******************/
+    double advanceState(int length_in, ScorerState * state_in, TokenId id_in);
+
     /******************
     * Creates a probability distrubution for each ngram of the specified length in the dictionary. 
     * Stores the results in the specified location. (wordList[i] has probability of probabilityList[i])
     * @param  length_in       length of ngrams to get distrubution for
     * @param  wordList        location to store the vector of unique tokens
     * @param  probabilityList location to store the probabilities
-    * @return 0 success
+    * @return 0  success
+    * @return -1 the length is counted in a sketch, which can not list its ngrams
     ******************/
     int makeDistrubution(int length_in, std::vector<std::vector<Type>> * wordList, std::vector<double> * probabilityList);
 
@@ -112,23 +290,101 @@ namespace nlp {
     int makeDistrubution(std::vector<std::vector<Type>> * wordList, std::vector<Type> * given_in, std::vector<Type> * choices, std::vector<double> * probabilityList);
     
     /******************
-    * Generates a random ngram from the document and stores it in the specified location
+    * Generates a random ngram from the document and stores it in the specified location.
+    * A context that nothing follows, like the end of the document, is shortened until something does
     * @param  length_in      length of ngrams to use for context of word generation
     * @param  location_in    location to store the resulting ngram
     * @param  sentencePrefix if this is >0 than the first word of the sentence will be a sentence 
     *                        starter from the dictionary otherwise it will be random
-    * @return 0 successful
+    * @return 0  successful
+    * @return -1 the document has no sentence ends or no tokens
     ******************/
     int generateSentence(int length_in, std::vector<Type> * location_in, int sentencePrefix);
+
+    /******************
+    * Generates many random sentences at once, splitting them between multiple threads.
+    * The same seed gives the same sentences for any number of threads
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the sentences start like the sentences of the document
+    * @param  numSentences_in number of sentences to generate
+    * @param  seed_in        seed the generator of every sentence is derived from
+    * @param  numThreads_in  number of threads to generate with
+    * @param  location_in    location to store the sentences, each ending with the end of sentence token
+    * @return 0  success
+    * @return -1 the document has no sentence ends or no tokens
+    ******************/
+    int generateSentences(int length_in, int sentencePrefix, int numSentences_in, unsigned long long seed_in, int numThreads_in, std::vector<std::vector<Type>> * location_in);
+
+    /******************
+    * Generates many random sentences at once as generateSentences does, writing them to a file as they are
+    * generated rather than keeping them all. Each sentence is written on its own line with its tokens
+    * separated by spaces and without the end of sentence token that closes it
+    * @param  length_in      length of ngrams to use for context of word generation
+    * @param  sentencePrefix if this is >0 the sentences start like the sentences of the document
+    * @param  numSentences_in number of sentences to generate
+    * @param  seed_in        seed the generator of every sentence is derived from
+    * @param  numThreads_in  number of threads to generate with
+    * @param  fileName_in    name of the file to write
+    * @return 0  success
+    * @return -1 the document has no sentence ends or no tokens, or the sentences could not be generated
+    * @return -2 file could not be written
+    ******************/
+    int generateSentences(int length_in, int sentencePrefix, int numSentences_in, unsigned long long seed_in, int numThreads_in, std::string fileName_in);
+
+    /******************
+    * Seeds the generator used by generateSentence so the sentences it generates can be repeated.
+    * Until this is called the generator is seeded with the time the document was created
+    * @param  seed_in seed for the generator
+    * @return 0 success
+    ******************/
+    int setSeed(unsigned long long seed_in);
+
+    /******************
+    * Adds an ngram to the document as Document::addNgram does, dropping the gathered successors
+    * since their counts would be out of date
+    * @param  nGram_in ngram to add
+    * @return 0  success
+    * @return -1 the document can not be added to
+    ******************/
+    int addNgram(std::vector<Type> * nGram_in);
+
+    /******************
+    * Prunes the document as Document::prune does with only the count cutoffs, dropping the gathered successors. The model does not back off,
+    * so the relative entropy scores would rate the dropped ngrams by a probability it never gives them
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in);
+
+    /******************
+    * Prunes the document with only the count cutoffs and scores held out sentences as Document::prune does,
+    * dropping the gathered successors
+    * @return the result of Document::prune
+    * @return -3 a threshold or a budget was given
+    ******************/
+    int prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in, int length_in,
+      std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in);
+
+    /******************
+    * Writes the probability of every stored ngram given the tokens before it to an ARPA file
+    * @param  fileName_in name of the file to write
+    * @return 0  success
+    * @return -1 file could not be written or a length is counted in a sketch
+    * @return -2 the document does not hold every length from 1 to its longest length
+    ******************/
+    int saveArpa(std::string fileName_in);
+
+    /******************
+    * Packs the counts as Document::packCounts does and stores the probability of every stored ngram
+    * as the code of a bin of its log, with the bins of each length chosen from its probabilities.
+    * Stored ngrams are then scored from their code alone, ngrams that are not stored as before
+    * @param  numBits_in number of bits of each code from 1 to QUANTIZED_MAX_BITS, 8 to 16 keeps the error small
+    * @return 0  success
+    * @return -1 the counts could not be packed into a trie
+    ******************/
+    int quantize(int numBits_in);
   };
 
 };
 
-/*******************
-* Randomly selects an index from a weighted probability set
-* @param  probabilities_in list of probabilities to selecte from (sums to 1)
-* @return the index of the selected probability
-*******************/
-int getRandomIndex(std::vector<double> * probabilities_in);
-
 #endif
\ No newline at end of file
@@ -16,57 +16,93 @@ namespace nlp {
 
   //Computes the probability of an ngram occuring given another ngram
   template <typename Type> double MLDocument<Type>::probabilityGiven(std::vector<Type> * given_in, std::vector<Type> * ngram_in) {
-    std::vector<Type> fullSentence;
-    int gramIterator;
+    return probabilityGiven(given_in->data(), given_in->size(), ngram_in->data(), ngram_in->size());
+  }
+
+  //Computes the probability of a token occuring given an ngram that precedes it
+  template <typename Type> double MLDocument<Type>::probabilityGiven(std::vector<Type> * given_in, Type * ngram_in) {
+    return probabilityGiven(given_in->data(), given_in->size(), ngram_in, 1);
+  }
 
-    //Initially the full sentence begins with the given text
-    fullSentence = *given_in;
-    //Add the remaining tokens to the sentence
-    for (gramIterator = 0; gramIterator < (int) ngram_in->size(); ++gramIterator) {
-      fullSentence.push_back((*ngram_in)[gramIterator]);
+  //Computes the probability of an ngram occuring given another ngram, both viewed in place
+  template <typename Type> double MLDocument<Type>::probabilityGiven(const Type * given_in, int givenLength_in, const Type * ngram_in, int ngramLength_in) {
+    TokenId ids[NGRAM_VIEW_LENGTH];
+    std::vector<TokenId> longIds;
+    TokenId * location;
+    int fullCount;
+    int givenCount;
+
+    if (givenLength_in + ngramLength_in > NGRAM_VIEW_LENGTH) {
+      longIds.resize(givenLength_in + ngramLength_in);
+      location = longIds.data();
+    } else {
+      location = ids;
     }
 
-    //If the sentence does not exist probability is 0
-    if (! this->hasNgram(&fullSentence)) {
+    //If a token was never seen the sentence does not exist and probability is 0
+    if (this->lexicon.findTokens(given_in, givenLength_in, location) || this->lexicon.findTokens(ngram_in, ngramLength_in, location + givenLength_in)) {
+      return 0;
+    }
+    fullCount = this->countIdsGiven(location, givenLength_in + ngramLength_in, givenLength_in, &givenCount);
+    if (fullCount == 0) {
       return 0;
     }
 
-    return ((double) ((double) this->countNgram(&fullSentence)) / ((double) this->countNgram(given_in)));
+    return ((double) fullCount) / ((double) givenCount);
   }
 
-  //Computes the probability of a token occuring given an ngram that precedes it
-  template <typename Type> double MLDocument<Type>::probabilityGiven(std::vector<Type> * given_in, Type * ngram_in) {
-    std::vector<Type> fullSentence;
+  //Computes the probability of the token stored just after a state's context given the context
+  template <typename Type> double MLDocument<Type>::nextProbability(ScorerState * state_in) {
+    int fullCount;
+    int givenCount;
+    double logProbability;
 
-    fullSentence = *given_in;
-    fullSentence.push_back(*ngram_in);
+    //Stored ngrams of a quantized document are scored from their code
+    if (this->quantizedProbability(state_in->context, state_in->contextLength + 1, &logProbability)) {
+      return exp(logProbability);
+    }
 
-    //If the sentence does not exist probability is 0
-    if (! this->hasNgram(&fullSentence)) {
+    //A token with no context is divided by the number of tokens in the document
+    fullCount = this->countIdsGiven(state_in->context, state_in->contextLength + 1, state_in->contextLength, &givenCount);
+    if (fullCount == 0) {
       return 0;
     }
 
-    return ((double) ((double) this->countNgram(&fullSentence)) / ((double) this->countNgram(given_in)));
+    return ((double) fullCount) / ((double) givenCount);
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double MLDocument<Type>::advanceState(int length_in, ScorerState * state_in, Type * token_in) {
+    //Tokens never seen keep an identifier no ngram contains
+    return advanceState(length_in, state_in, this->lexicon.findToken(token_in));
+  }
+
+  //Scores the next token of a sentence given the tokens held by a state
+  template <typename Type> double MLDocument<Type>::advanceState(int length_in, ScorerState * state_in, TokenId id_in) {
+    double result;
+
+    trimState(state_in, length_in);
+    state_in->context[state_in->contextLength] = id_in;
+    result = log(nextProbability(state_in));
+    acceptState(state_in, length_in, result);
+
+    return result;
   }
 
   //Computes the probability of a sentence occuring based
   template <typename Type> double MLDocument<Type>::sentenceProbability(int length_in, std::vector<Type> * sentence_in) {
-    std::vector<Type> currentNgram;
+    ScorerState state;
     int tokenIterator;
     double result;
 
-    //Initially probability is simply probability of first word
-    currentNgram.push_back((*sentence_in)[0]);
-    result = ngramProbability(&currentNgram);
-
-    for (tokenIterator = 1; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
-      //Trim any excess tokens from the current given nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      result = result * probabilityGiven(&currentNgram, &((*sentence_in)[tokenIterator]));
-      //Add the new token to the end of the nGram
-      currentNgram.push_back((*sentence_in)[tokenIterator]);
+    resetState(&state);
+    result = 1;
+    for (tokenIterator = 0; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
+      trimState(&state, length_in);
+      state.context[state.contextLength] = this->lexicon.findToken(&(*sentence_in)[tokenIterator]);
+      result = result * nextProbability(&state);
+      //Only the product is kept so the state's log probability is left alone
+      acceptState(&state, length_in, 0);
     }
 
     return result;
@@ -74,43 +110,29 @@ namespace nlp {
 
   //Computes the probability of a sentence occuring based on the maximum-likliehood language model
   template <typename Type> double MLDocument<Type>::logSentenceProbability(int length_in, std::vector<Type> * sentence_in) {
-    std::vector<Type> currentNgram;
+    ScorerState state;
     int tokenIterator;
-    double result;
-    
-    //Initially probability is simply probability of first word
-    currentNgram.push_back((*sentence_in)[0]);
-    result = log(ngramProbability(&currentNgram));
-
-    for (tokenIterator = 1; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
-      //Trim any excess tokens from the current given nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
-      }
-      result = result + log(probabilityGiven(&currentNgram, &((*sentence_in)[tokenIterator])));
-      //Add the new token to the end of the nGram
-      currentNgram.push_back((*sentence_in)[tokenIterator]);
+
+    //The context of each token slides along in place rather than being copied
+    resetState(&state);
+    for (tokenIterator = 0; tokenIterator < (int) sentence_in->size(); ++tokenIterator) {
+      advanceState(length_in, &state, &(*sentence_in)[tokenIterator]);
     }
 
-    return result;
+    return state.logProbability;
   }
 
   //Creates a probability distrubution for each ngram of the specified length in the dictionary.
   template <typename Type> int MLDocument<Type>::makeDistrubution(int length_in, std::vector<std::vector<Type>> * ngramList, std::vector<double> * probabilityList) {
-    int index;
-
-    index = this->getIndex(length_in);
-
-    for (auto iterator = this->dictionary[index].begin(); iterator != this->dictionary[index].end(); ++iterator) {
+    return this->forEachNgram(length_in, [&](const TokenId * key_in, int) {
       //Extract the current ngram we are iteratin over
-      std::vector<Type> currentNgram = iterator->first;
+      std::vector<Type> currentNgram;
+      this->lexicon.getTokens(key_in, length_in, &currentNgram);
       //Push the ngram to the list of ngrams
       ngramList->push_back(currentNgram);
       //Push the probability to the list of probabilities
       probabilityList->push_back(ngramProbability(&currentNgram));
-    }
-    
-    return 0;
+    });
   }
 
   template <typename Type> int MLDocument<Type>::makeDistrubution(std::vector<std::vector<Type>> * wordList, std::vector<Type> * given_in, std::vector<Type> * choices, std::vector<double> * probabilityList) {
@@ -135,110 +157,367 @@ namespace nlp {
     return 0;
   }
 
-  //Generates a random ngram from the document and stores it in the specified location
-  template <typename Type> int MLDocument<Type>::generateSentence(int length_in, std::vector<Type> * location_in, int sentencePrefix) {
-    std::vector<Type> result;
-    std::vector<std::vector<Type>> words;
-    std::vector<double> probabilities;
-    std::vector<Type> currentNgram;
+  //Gathers the tokens that follow every context of a length
+  template <typename Type> int MLDocument<Type>::gatherSuccessors(int length_in) {
+    if (length_in < (int) successorLists.size() && ! successorLists[length_in].empty()) {
+      return 0;
+    }
+    if (this->hasNgrams(length_in + 1) != 1) {
+      return -1;
+    }
+    if (length_in >= (int) successorLists.size()) {
+      successorLists.resize(length_in + 1);
+      successorIndexes.resize(length_in + 1);
+    }
+
+    std::vector<SuccessorList> & lists = successorLists[length_in];
+    NgramTable<int> & indexes = successorIndexes[length_in];
+    indexes = NgramTable<int>(length_in);
+    //Every single token follows the empty context
+    if (length_in == 0) {
+      lists.resize(1);
+    }
+    if (this->forEachNgram(length_in + 1, [&](const TokenId * key_in, int count_in) {
+      int * index;
+
+      index = length_in == 0 ? NULL : indexes.find(key_in);
+      if (length_in > 0 && index == NULL) {
+        index = indexes.insert(key_in);
+        *index = (int) lists.size();
+        lists.push_back(SuccessorList());
+      }
+      SuccessorList & list = lists[index == NULL ? 0 : *index];
+      list.successors.push_back(key_in[length_in]);
+      list.weights.push_back((double) count_in);
+    })) {
+      //Successors of only the heavy hitters would be drawn as if they were all of them
+      lists.clear();
+      return -1;
+    }
+
+    return 0;
+  }
+
+  //Draws a token to follow a context
+  template <typename Type> int MLDocument<Type>::sampleSuccessor(const TokenId * context_in, int length_in, RandomGenerator * generator_in, TokenId * location_in) {
+    int * index;
+    SuccessorList * list;
+
+    if (gatherSuccessors(length_in)) {
+      return -1;
+    }
+    index = length_in == 0 ? NULL : successorIndexes[length_in].find(context_in);
+    if (length_in > 0 && index == NULL) {
+      return -1;
+    }
+    list = &successorLists[length_in][index == NULL ? 0 : *index];
 
-    //Reseed the random generator
-    srand(time(NULL));
+    //The table replaces the counts the first time the context is drawn from
+    if (list->table.size() == 0) {
+      if (list->table.build(&list->weights)) {
+        return -1;
+      }
+      std::vector<double>().swap(list->weights);
+    }
+    *location_in = list->successors[list->table.sample(generator_in)];
+
+    return 0;
+  }
+
+  //Generates the identifiers of a random sentence
+  template <typename Type> int MLDocument<Type>::generateIds(int length_in, int sentencePrefix, TokenId endId_in, RandomGenerator * generator_in, std::vector<TokenId> * location_in) {
+    std::vector<TokenId> & sentence = *location_in;
+    TokenId next;
+    int contextLength;
+
+    sentence.clear();
+    //The end of the previous sentence stays in the context
+    if (sentencePrefix) {
+      sentence.push_back(endId_in);
+    }
+
+    //Continue to add words to the sentence until an EOS is found
+    do {
+      //A length of 1 has no context, otherwise use as many of the last tokens as fit
+      contextLength = std::min(length_in - 1, (int) sentence.size());
+      if (contextLength < 0) {
+        contextLength = 0;
+      }
+      //The first token follows the end of the previous sentence even when the later ones have no context
+      if (sentencePrefix && sentence.size() == 1) {
+        contextLength = SENTENCE_PREFIX_NGRAM_LENGTH - 1;
+      }
+      //Contexts that nothing follows are shortened until something does
+      while (sampleSuccessor(sentence.data() + sentence.size() - contextLength, contextLength, generator_in, &next)) {
+        if (contextLength == 0) {
+          return -1;
+        }
+        --contextLength;
+      }
+      sentence.push_back(next);
+    } while (next != endId_in);
+
+    return 0;
+  }
 
-    //Make a distrubution of all the words in the dictionary
-    makeDistrubution(1, &words, &probabilities);
+  //Generates a random ngram from the document and stores it in the specified location
+  template <typename Type> int MLDocument<Type>::generateSentence(int length_in, std::vector<Type> * location_in, int sentencePrefix) {
+    std::vector<TokenId> sentence;
+    Type end;
+    TokenId endId;
+    int start;
+
+    end = EOS;
+    endId = this->lexicon.findToken(&end);
+    if (endId == UNKNOWN_TOKEN_ID) {
+      return -1;
+    }
 
     //Sentence generation with specified context size requires ngrams of said size
     this->readTokens(length_in);
-
-    //Check if a proper sentence prefix is to be generated
+    //Prefix requires ngrams of size two to be in the dictionary
     if (sentencePrefix) {
-      //Prefix requires ngrams of size two to be in the dictionary
       this->readTokens(SENTENCE_PREFIX_NGRAM_LENGTH);
+    }
+    if (generateIds(length_in, sentencePrefix, endId, &generator, &sentence)) {
+      return -1;
+    }
 
-      //Create the structures to hold the options to hold from
-      std::vector<Type> startOptions;
-      std::vector<double> startProbabilities;
+    //Store the created sentence in the specified location, the end of the previous sentence is not part of it
+    start = sentencePrefix ? 1 : 0;
+    this->lexicon.getTokens(sentence.data() + start, (int) sentence.size() - start, location_in);
+    return 0;
+  }
 
-      currentNgram.push_back(EOS);
+  //Reads the ngrams and builds every table that generating sentences with a context length needs
+  template <typename Type> int MLDocument<Type>::prepareGeneration(int length_in, int sentencePrefix, TokenId * endId_out) {
+    Type end;
+    int lengthIterator;
+    int listIterator;
 
-      //Create a distrubution across the current words
-      makeDistrubution(&words, &currentNgram, &startOptions, &startProbabilities);
-      result.push_back(startOptions[getRandomIndex(&startProbabilities)]);
-    } else {
-      //If we do not want a proper setence prefix just randomly select a first word
-      result.push_back(words[getRandomIndex(&probabilities)][0]);
+    end = EOS;
+    *endId_out = this->lexicon.findToken(&end);
+    if (*endId_out == UNKNOWN_TOKEN_ID) {
+      return -1;
+    }
+    this->readTokens(length_in);
+    if (sentencePrefix) {
+      this->readTokens(SENTENCE_PREFIX_NGRAM_LENGTH);
     }
 
-    //Length of 1 is a special case as it requires no context
-    if (length_in == 1) {
-      while (result[result.size() - 1] != EOS) {
-        result.push_back(words[getRandomIndex(&probabilities)][0]);
+    //Sentences never need more context than the length allows, or than the prefix gives a length of 1
+    for (lengthIterator = 0; lengthIterator < std::max(length_in - 1, sentencePrefix ? 1 : 0) + 1; ++lengthIterator) {
+      if (gatherSuccessors(lengthIterator)) {
+        if (lengthIterator == 0) {
+          return -1;
+        }
+        continue;
+      }
+      for (listIterator = 0; listIterator < (int) successorLists[lengthIterator].size(); ++listIterator) {
+        SuccessorList & list = successorLists[lengthIterator][listIterator];
+        if (list.table.size() == 0 && list.table.build(&list.weights) == 0) {
+          std::vector<double>().swap(list.weights);
+        }
       }
-      *location_in = result;
-      return 0;
     }
 
-    currentNgram.push_back(result[0]);
+    return 0;
+  }
 
-    //Continue to add words to the sentence until an EOS is found
-    while (result[result.size() - 1] != EOS) {
-      //Trim any excess tokens from the current nGram
-      while ((int) currentNgram.size() >= length_in) {
-        currentNgram.erase(currentNgram.begin());
+  //Generates blocks of sentences until none are left
+  template <typename Type> int MLDocument<Type>::generateBlocks(int length_in, int sentencePrefix, TokenId endId_in, unsigned long long seed_in, int first_in,
+    std::atomic<int> * next_in, std::vector<std::vector<TokenId>> * ids_out, std::vector<std::vector<Type>> * tokens_out) {
+    RandomGenerator sentenceGenerator;
+    std::vector<TokenId> sentence;
+    std::vector<TokenId> * current;
+    int numSentences;
+    int blockStart;
+    int sentenceIterator;
+    int start;
+
+    numSentences = ids_out == NULL ? tokens_out->size() : ids_out->size();
+    start = sentencePrefix ? 1 : 0;
+    while ((blockStart = (*next_in)++ * GENERATE_BLOCK_LENGTH) < numSentences) {
+      for (sentenceIterator = blockStart; sentenceIterator < std::min(blockStart + GENERATE_BLOCK_LENGTH, numSentences); ++sentenceIterator) {
+        //The stream of each sentence depends only on the seed and the sentence's number
+        std::seed_seq streamSeed{(unsigned int) seed_in, (unsigned int) (seed_in >> 32), (unsigned int) (first_in + sentenceIterator)};
+        sentenceGenerator.seed(streamSeed);
+        current = ids_out == NULL ? &sentence : &(*ids_out)[sentenceIterator];
+        generateIds(length_in, sentencePrefix, endId_in, &sentenceGenerator, current);
+        //Each thread writes only its own sentences so no locking is needed
+        if (ids_out == NULL) {
+          this->lexicon.getTokens(sentence.data() + start, (int) sentence.size() - start, &(*tokens_out)[sentenceIterator]);
+        } else {
+          current->erase(current->begin(), current->begin() + start);
+        }
       }
-      
-      //Create the structures to hold the options to hold from
-      std::vector<Type> wordOptions;
-      std::vector<double> probabilityOptions;
+    }
 
-      //Create a distrubution across the current words
-      makeDistrubution(&words, &currentNgram, &wordOptions, &probabilityOptions);
-      result.push_back(wordOptions[getRandomIndex(&probabilityOptions)]);
+    return 0;
+  }
 
-      //Append the new word to the current ngram
-      currentNgram.push_back(result[result.size() - 1]);
+  //Runs generateBlocks on each thread and waits for them to finish
+  template <typename Type> int MLDocument<Type>::generateAll(int length_in, int sentencePrefix, TokenId endId_in, unsigned long long seed_in, int first_in,
+    int numThreads_in, std::vector<std::vector<TokenId>> * ids_out, std::vector<std::vector<Type>> * tokens_out) {
+    std::vector<std::thread> threads;
+    std::atomic<int> next;
+    int numBlocks;
+    int threadIterator;
+
+    next = 0;
+    numBlocks = ((ids_out == NULL ? tokens_out->size() : ids_out->size()) + GENERATE_BLOCK_LENGTH - 1) / GENERATE_BLOCK_LENGTH;
+    //A single block is generated on the calling thread
+    if (numThreads_in <= 1 || numBlocks <= 1) {
+      return generateBlocks(length_in, sentencePrefix, endId_in, seed_in, first_in, &next, ids_out, tokens_out);
+    }
+    for (threadIterator = 0; threadIterator < std::min(numThreads_in, numBlocks); ++threadIterator) {
+      threads.push_back(std::thread(&MLDocument<Type>::generateBlocks, this, length_in, sentencePrefix, endId_in, seed_in, first_in, &next, ids_out, tokens_out));
+    }
+    for (threadIterator = 0; threadIterator < (int) threads.size(); ++threadIterator) {
+      threads[threadIterator].join();
     }
 
-    //Store the created sentence in the specified location
-    *location_in = result;
     return 0;
   }
 
+  //Generates many random sentences at once, splitting them between multiple threads
+  template <typename Type> int MLDocument<Type>::generateSentences(int length_in, int sentencePrefix, int numSentences_in, unsigned long long seed_in, int numThreads_in, std::vector<std::vector<Type>> * location_in) {
+    TokenId endId;
+
+    if (prepareGeneration(length_in, sentencePrefix, &endId)) {
+      return -1;
+    }
+    location_in->clear();
+    location_in->resize(numSentences_in);
+
+    return generateAll(length_in, sentencePrefix, endId, seed_in, 0, numThreads_in, NULL, location_in);
+  }
+
+  //Generates many random sentences at once, writing them to a file as they are generated
+  template <typename Type> int MLDocument<Type>::generateSentences(int length_in, int sentencePrefix, int numSentences_in, unsigned long long seed_in, int numThreads_in, std::string fileName_in) {
+    std::vector<std::vector<TokenId>> round;
+    std::vector<std::string> words;
+    TokenId endId;
+    FILE * file;
+    int first;
+    int sentenceIterator;
+    int tokenIterator;
+
+    if (prepareGeneration(length_in, sentencePrefix, &endId)) {
+      return -1;
+    }
+    file = fopen(fileName_in.c_str(), "w");
+    if (file == NULL) {
+      return -2;
+    }
+
+    //The bytes of every token are found once rather than for each time it is written
+    words.resize(this->lexicon.size());
+    for (tokenIterator = 0; tokenIterator < (int) words.size(); ++tokenIterator) {
+      tokenToBytes(this->lexicon.getToken(tokenIterator), &words[tokenIterator]);
+    }
+
+    //Only one round of sentences is held at a time, each written in order once the threads finish it
+    for (first = 0; first < numSentences_in; first += GENERATE_ROUND_LENGTH) {
+      round.resize(std::min(GENERATE_ROUND_LENGTH, numSentences_in - first));
+      if (generateAll(length_in, sentencePrefix, endId, seed_in, first, numThreads_in, &round, NULL)) {
+        fclose(file);
+        return -1;
+      }
+      for (sentenceIterator = 0; sentenceIterator < (int) round.size(); ++sentenceIterator) {
+        std::vector<TokenId> & sentence = round[sentenceIterator];
+        for (tokenIterator = 0; tokenIterator < (int) sentence.size() - 1; ++tokenIterator) {
+          if (tokenIterator > 0) {
+            fputc(' ', file);
+          }
+          fwrite(words[sentence[tokenIterator]].data(), 1, words[sentence[tokenIterator]].size(), file);
+        }
+        fputc('\n', file);
+      }
+    }
+
+    return fclose(file) == 0 ? 0 : -2;
+  }
+
+  //Seeds the generator used by generateSentence
+  template <typename Type> int MLDocument<Type>::setSeed(unsigned long long seed_in) {
+    generator.seed(seed_in);
+    return 0;
+  }
+
+  //Adds an ngram to the document, dropping the gathered successors
+  template <typename Type> int MLDocument<Type>::addNgram(std::vector<Type> * nGram_in) {
+    successorLists.clear();
+    successorIndexes.clear();
+    return Document<Type>::addNgram(nGram_in);
+  }
+
+  //Prunes the document, dropping the gathered successors
+  template <typename Type> int MLDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, PruneStats * location_in) {
+    //Without backing off a dropped ngram gets no probability, not the one its score was found with
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    successorLists.clear();
+    successorIndexes.clear();
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, location_in);
+  }
+
+  //Prunes the document and scores held out sentences, dropping the gathered successors
+  template <typename Type> int MLDocument<Type>::prune(std::vector<int> * cutoffs_in, double threshold_in, size_t numBytes_in, LanguageModel<Type> * model_in,
+    int length_in, std::vector<std::vector<Type>> * heldOut_in, PruneStats * location_in) {
+    //Without backing off a dropped ngram gets no probability, not the one its score was found with
+    if (threshold_in > 0 || numBytes_in > 0) {
+      return -3;
+    }
+    successorLists.clear();
+    successorIndexes.clear();
+    return Document<Type>::prune(cutoffs_in, threshold_in, numBytes_in, model_in, length_in, heldOut_in, location_in);
+  }
+
+  //Writes the probability of every stored ngram given the tokens before it to an ARPA file
+  template <typename Type> int MLDocument<Type>::saveArpa(std::string fileName_in) {
+    return this->writeArpa(fileName_in, [this](std::vector<Type> * ngram_in) {
+      std::vector<Type> given(ngram_in->begin(), ngram_in->end() - 1);
+      //Single tokens have no context so their probability is taken over the whole document
+      if (given.empty()) {
+        return ngramProbability(ngram_in);
+      }
+      return probabilityGiven(&given, &ngram_in->back());
+    });
+  }
+
+  //Stores the probability of every stored ngram as the code of a bin of its log
+  template <typename Type> int MLDocument<Type>::quantize(int numBits_in) {
+    return this->quantizeProbabilities(numBits_in, [this](ScorerState * state_in, int) {
+      return nextProbability(state_in);
+    });
+  }
+
   //Inherited constructors
   template <typename Type> MLDocument<Type>::MLDocument(std::vector<Type> * tokens_in, int gramLength_in)
-    :Document<Type>(tokens_in, gramLength_in) {}
+    :Document<Type>(tokens_in, gramLength_in), generator(time(NULL)) {}
   template <typename Type> MLDocument<Type>::MLDocument(std::vector<Type> * tokens_in, int gramLengthLow_in, int gramLengthHigh_in)
-    :Document<Type>(tokens_in, gramLengthLow_in, gramLengthHigh_in) {}
+    :Document<Type>(tokens_in, gramLengthLow_in, gramLengthHigh_in), generator(time(NULL)) {}
   template <typename Type> MLDocument<Type>::MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in)
-    :Document<Type>(tokens_in, gramLengths_in) {}
+    :Document<Type>(tokens_in, gramLengths_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, int numThreads_in)
+    :Document<Type>(tokens_in, gramLengths_in, numThreads_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(Lexicon<Type> * lexicon_in, std::vector<TokenId> * tokens_in, std::vector<int> * gramLengths_in)
+    :Document<Type>(lexicon_in, tokens_in, gramLengths_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, int keepTokens_in)
+    :Document<Type>(source_in, gramLengths_in, keepTokens_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(std::vector<Type> * tokens_in, std::vector<int> * gramLengths_in, SketchOptions * options_in)
+    :Document<Type>(tokens_in, gramLengths_in, options_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(TokenSource<Type> * source_in, std::vector<int> * gramLengths_in, SketchOptions * options_in)
+    :Document<Type>(source_in, gramLengths_in, options_in), generator(time(NULL)) {}
+  template <typename Type> MLDocument<Type>::MLDocument(ModelFile * model_in)
+    :Document<Type>(model_in), generator(time(NULL)) {}
 
   //Default constructor and destructor
-  template <typename Type> MLDocument<Type>::MLDocument() {}
+  template <typename Type> MLDocument<Type>::MLDocument() :generator(time(NULL)) {}
   template <typename Type> MLDocument<Type>::~MLDocument() {}
 
 };
 
-//Randomly selects an index from a weighted probability set
-int getRandomIndex(std::vector<double> * probabilities_in) {
-  double accumulator;
-  int probabilityIterator;
-  int numProbabilities;
-  double randomVal;
-
-  //Store the amount of probabilities to select from
-  numProbabilities = probabilities_in->size();
-  randomVal = ((double) (rand() % numProbabilities) ) / (double) numProbabilities;
-
-  accumulator = 0;
-  for (probabilityIterator = 0; probabilityIterator < numProbabilities; probabilityIterator++) {
-    accumulator += (*probabilities_in)[probabilityIterator];
-    if (accumulator > randomVal) {
-      return probabilityIterator;
-    }
-  }
-
-  return numProbabilities - 1;
-}
-
 #endif
\ No newline at end of file
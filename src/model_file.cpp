@@ -0,0 +1,227 @@
+//A binary file holding the counts of a document that can be mapped into memory and queried in place
+
+#include <cstdio>  //fopen()   fwrite()
+#include <cstring> //memcmp()   memcpy()
+
+#include "model_file.h"
+
+namespace nlp {
+
+  //Rounds a byte offset up to the next 8 byte boundary
+  static unsigned long long alignOffset(unsigned long long offset_in) {
+    return (offset_in + 7) & ~7ull;
+  }
+
+  //Writes zeros until the file reaches the specified offset
+  static int padTo(FILE * file_in, unsigned long long * written_in, unsigned long long offset_in) {
+    char zero;
+
+    zero = 0;
+    while (*written_in < offset_in) {
+      fwrite(&zero, 1, 1, file_in);
+      ++*written_in;
+    }
+
+    return 0;
+  }
+
+  //Writes bytes to the file and keeps track of how many have been written
+  static int writeBytes(FILE * file_in, unsigned long long * written_in, const void * bytes_in, size_t length_in) {
+    if (length_in > 0 && fwrite(bytes_in, 1, length_in, file_in) != length_in) {
+      return -1;
+    }
+    *written_in += length_in;
+
+    return 0;
+  }
+
+  //Maps a model file into memory
+  int ModelFile::open(std::string fileName_in) {
+    const ModelHeader * header;
+
+    close();
+
+    //Queries jump around the file so it is not read ahead
+    if (file.open(fileName_in, 0)) {
+      return -1;
+    }
+    data = file.getData();
+    size = file.getSize();
+
+    //Refuse files written by something else or with a different layout
+    header = getHeader();
+    if (size < sizeof(ModelHeader) || memcmp(header->magic, MODEL_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != MODEL_FILE_VERSION
+      || header->wordsOffset > size || header->ordersOffset > size || header->frequenciesOffset > size) {
+      close();
+      return -2;
+    }
+
+    return 0;
+  }
+
+  //Unmaps the current file
+  int ModelFile::close() {
+    file.close();
+    data = NULL;
+    size = 0;
+
+    return 0;
+  }
+
+  //Finds the header of the mapped file
+  const ModelHeader * ModelFile::getHeader() {
+    return (const ModelHeader *) data;
+  }
+
+  //Finds the bytes of a token in the lexicon
+  const char * ModelFile::getWord(TokenId id_in, int * length_out) {
+    const unsigned long long * offsets;
+    const char * bytes;
+
+    offsets = (const unsigned long long *) (data + getHeader()->wordsOffset);
+    bytes = (const char *) (offsets + getHeader()->numWords + 1);
+    *length_out = offsets[id_in + 1] - offsets[id_in];
+
+    return bytes + offsets[id_in];
+  }
+
+  //Finds the stored ngrams of an order
+  SortedNgrams ModelFile::getOrder(int index_in) {
+    const OrderHeader * order;
+    SortedNgrams result;
+
+    order = (const OrderHeader *) (data + getHeader()->ordersOffset) + index_in;
+    result.length = order->length;
+    result.numEntries = order->numEntries;
+    result.keys = (const TokenId *) (data + order->keysOffset);
+    result.counts = (const int *) (data + order->countsOffset);
+
+    return result;
+  }
+
+  //Finds the good turing tables of an order
+  int ModelFile::getFrequencies(int index_in, const FrequencyPair ** frequencies_out, int * numFrequencies_out,
+    const ProbabilityPair ** probabilities_out, int * numProbabilities_out) {
+    const FrequencyHeader * frequency;
+
+    if (getHeader()->frequenciesOffset == 0) {
+      return -1;
+    }
+
+    frequency = (const FrequencyHeader *) (data + getHeader()->frequenciesOffset) + index_in;
+    *frequencies_out = (const FrequencyPair *) (data + frequency->frequenciesOffset);
+    *numFrequencies_out = frequency->numFrequencies;
+    *probabilities_out = (const ProbabilityPair *) (data + frequency->probabilitiesOffset);
+    *numProbabilities_out = frequency->numProbabilities;
+
+    return 0;
+  }
+
+  //Writes a model file
+  int ModelFile::write(std::string fileName_in, ModelHeader * header_in, std::vector<std::string> * words_in,
+    std::vector<SortedNgrams> * orders_in, std::vector<std::vector<FrequencyPair>> * frequencies_in,
+    std::vector<std::vector<ProbabilityPair>> * probabilities_in) {
+    std::vector<unsigned long long> wordOffsets;
+    std::vector<OrderHeader> orders;
+    std::vector<FrequencyHeader> frequencies;
+    unsigned long long position;
+    unsigned long long written;
+    int wordIterator;
+    int orderIterator;
+    int result;
+    FILE * file;
+
+    //Lay out every section before writing anything
+    memcpy(header_in->magic, MODEL_FILE_MAGIC, sizeof(header_in->magic));
+    header_in->version = MODEL_FILE_VERSION;
+    header_in->numWords = words_in->size();
+    header_in->numOrders = orders_in->size();
+
+    position = alignOffset(sizeof(ModelHeader));
+    header_in->wordsOffset = position;
+    wordOffsets.push_back(0);
+    for (wordIterator = 0; wordIterator < (int) words_in->size(); ++wordIterator) {
+      wordOffsets.push_back(wordOffsets.back() + (*words_in)[wordIterator].size());
+    }
+    position = alignOffset(position + wordOffsets.size() * sizeof(unsigned long long) + wordOffsets.back());
+
+    header_in->ordersOffset = position;
+    position += orders_in->size() * sizeof(OrderHeader);
+    for (orderIterator = 0; orderIterator < (int) orders_in->size(); ++orderIterator) {
+      OrderHeader order;
+      order.length = (*orders_in)[orderIterator].length;
+      order.numEntries = (*orders_in)[orderIterator].numEntries;
+      order.keysOffset = alignOffset(position);
+      order.countsOffset = alignOffset(order.keysOffset + (unsigned long long) order.numEntries * order.length * sizeof(TokenId));
+      position = order.countsOffset + (unsigned long long) order.numEntries * sizeof(int);
+      orders.push_back(order);
+    }
+
+    //Only good turing models have frequency tables
+    header_in->frequenciesOffset = 0;
+    if (! frequencies_in->empty()) {
+      position = alignOffset(position);
+      header_in->frequenciesOffset = position;
+      position += frequencies_in->size() * sizeof(FrequencyHeader);
+      for (orderIterator = 0; orderIterator < (int) frequencies_in->size(); ++orderIterator) {
+        FrequencyHeader frequency;
+        frequency.numFrequencies = (*frequencies_in)[orderIterator].size();
+        frequency.numProbabilities = (*probabilities_in)[orderIterator].size();
+        frequency.frequenciesOffset = alignOffset(position);
+        frequency.probabilitiesOffset = alignOffset(frequency.frequenciesOffset + frequency.numFrequencies * sizeof(FrequencyPair));
+        position = frequency.probabilitiesOffset + frequency.numProbabilities * sizeof(ProbabilityPair);
+        frequencies.push_back(frequency);
+      }
+    }
+
+    file = fopen(fileName_in.c_str(), "wb");
+    if (file == NULL) {
+      return -1;
+    }
+
+    written = 0;
+    result = writeBytes(file, &written, header_in, sizeof(ModelHeader));
+    padTo(file, &written, header_in->wordsOffset);
+    result |= writeBytes(file, &written, wordOffsets.data(), wordOffsets.size() * sizeof(unsigned long long));
+    for (wordIterator = 0; wordIterator < (int) words_in->size(); ++wordIterator) {
+      result |= writeBytes(file, &written, (*words_in)[wordIterator].data(), (*words_in)[wordIterator].size());
+    }
+
+    padTo(file, &written, header_in->ordersOffset);
+    result |= writeBytes(file, &written, orders.data(), orders.size() * sizeof(OrderHeader));
+    for (orderIterator = 0; orderIterator < (int) orders.size(); ++orderIterator) {
+      padTo(file, &written, orders[orderIterator].keysOffset);
+      result |= writeBytes(file, &written, (*orders_in)[orderIterator].keys,
+        (size_t) orders[orderIterator].numEntries * orders[orderIterator].length * sizeof(TokenId));
+      padTo(file, &written, orders[orderIterator].countsOffset);
+      result |= writeBytes(file, &written, (*orders_in)[orderIterator].counts, (size_t) orders[orderIterator].numEntries * sizeof(int));
+    }
+
+    if (header_in->frequenciesOffset != 0) {
+      padTo(file, &written, header_in->frequenciesOffset);
+      result |= writeBytes(file, &written, frequencies.data(), frequencies.size() * sizeof(FrequencyHeader));
+      for (orderIterator = 0; orderIterator < (int) frequencies.size(); ++orderIterator) {
+        padTo(file, &written, frequencies[orderIterator].frequenciesOffset);
+        result |= writeBytes(file, &written, (*frequencies_in)[orderIterator].data(), frequencies[orderIterator].numFrequencies * sizeof(FrequencyPair));
+        padTo(file, &written, frequencies[orderIterator].probabilitiesOffset);
+        result |= writeBytes(file, &written, (*probabilities_in)[orderIterator].data(), frequencies[orderIterator].numProbabilities * sizeof(ProbabilityPair));
+      }
+    }
+
+    if (fclose(file) != 0) {
+      result = -1;
+    }
+
+    return result == 0 ? 0 : -1;
+  }
+
+  //Default constructor and destructor
+  ModelFile::ModelFile() {
+    data = NULL;
+    size = 0;
+  }
+  ModelFile::~ModelFile() {
+    close();
+  }
+
+};
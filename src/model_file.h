@@ -0,0 +1,289 @@
+/**************************************************************
+* A binary file holding the counts of a document that can be
+* mapped into memory and queried in place. Every process that
+* maps the same file shares one copy of it in the page cache
+*
+* Layout, every section starts on an 8 byte boundary:
+*   ModelHeader
+*   word offsets (numWords + 1 unsigned long long), word bytes
+*   OrderHeader for each order, then for each order its keys
+*     sorted in increasing order followed by their counts
+*   FrequencyHeader for each ngram length starting at 1, then
+*     for each length its (count, frequency) pairs and
+*     (count, probability) pairs
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_MODEL_FILE
+#define _H_MODEL_FILE
+
+#include <string> //std::string
+#include <vector> //std::vector
+
+#include "lexicon.h"
+#include "mapped_file.h"
+
+#define MODEL_FILE_MAGIC "NLPMODEL"
+#define MODEL_FILE_VERSION 1
+
+#define MODEL_KIND_DOCUMENT 0
+#define MODEL_KIND_GT 1
+#define MODEL_KIND_AD 2
+
+//ARPA files use this in place of the log10 of a probability of 0
+#define ARPA_LOG_ZERO -99
+
+namespace nlp {
+
+  struct ModelHeader {
+    /* Always MODEL_FILE_MAGIC */
+    char magic[8];
+
+    /* Version of the layout the file was written with */
+    unsigned int version;
+
+    /* Which language model wrote the file */
+    unsigned int kind;
+
+    /* Amount of tokens in the document */
+    long long numTokens;
+
+    /* Number of distinct tokens in the lexicon */
+    int numWords;
+
+    /* Number of ngram lengths stored */
+    int numOrders;
+
+    /* Delta value of an add delta model */
+    double delta;
+
+    /* Threshold of a good turing model */
+    int threshold;
+
+    /* Vocabulary size of a good turing model */
+    int vocabulary;
+
+    /* Byte offsets of each section from the start of the file */
+    unsigned long long wordsOffset;
+    unsigned long long ordersOffset;
+    unsigned long long frequenciesOffset;
+  };
+
+  struct OrderHeader {
+    /* Number of token identifiers in each key */
+    int length;
+
+    /* Number of keys stored for this length */
+    int numEntries;
+
+    /* Byte offsets of the keys and counts from the start of the file */
+    unsigned long long keysOffset;
+    unsigned long long countsOffset;
+  };
+
+  struct FrequencyHeader {
+    /* Number of (count, frequency) pairs */
+    int numFrequencies;
+
+    /* Number of (count, probability) pairs */
+    int numProbabilities;
+
+    /* Byte offsets of the pairs from the start of the file */
+    unsigned long long frequenciesOffset;
+    unsigned long long probabilitiesOffset;
+  };
+
+  /* A count and the number of ngrams that occur that many times */
+  struct FrequencyPair {
+    int count;
+    int frequency;
+  };
+
+  /* A count and the probability given to ngrams that occur that many times */
+  struct ProbabilityPair {
+    int count;
+    int padding;
+    double probability;
+  };
+
+  /* Ngrams of one length stored as sorted keys with their counts, which need not be owned */
+  struct SortedNgrams {
+    /* Number of token identifiers in each key */
+    int length;
+
+    /* Number of keys stored */
+    int numEntries;
+
+    /* The keys, one after another, in increasing order */
+    const TokenId * keys;
+
+    /* The count of each key */
+    const int * counts;
+
+    /*******************
+    * Finds the count of a key by binary search
+    * @param  key_in identifiers of the key to find
+    * @return pointer to the count of the key
+    * @return NULL key is not stored
+    *******************/
+    const int * find(const TokenId * key_in);
+  };
+
+  //Finds the count of a key by binary search
+  inline const int * SortedNgrams::find(const TokenId * key_in) {
+    int low;
+    int high;
+    int middle;
+    int comparison;
+    int keyIterator;
+    const TokenId * current;
+
+    low = 0;
+    high = numEntries;
+    while (low < high) {
+      middle = low + (high - low) / 2;
+      current = keys + (size_t) middle * length;
+      comparison = 0;
+      for (keyIterator = 0; keyIterator < length; ++keyIterator) {
+        if (current[keyIterator] != key_in[keyIterator]) {
+          comparison = current[keyIterator] < key_in[keyIterator] ? -1 : 1;
+          break;
+        }
+      }
+      if (comparison == 0) {
+        return &counts[middle];
+      }
+      if (comparison < 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+
+    return NULL;
+  }
+
+  class ModelFile {
+  private:
+    /* The mapped model file */
+    MappedFile file;
+
+    /* The mapped contents of the file */
+    const char * data;
+
+    /* Number of bytes in the file */
+    size_t size;
+
+  public:
+    //Default constructor and destructor
+    ModelFile();
+    ~ModelFile();
+
+    //A model file owns its mapping so it can not be copied
+    ModelFile(const ModelFile & model_in) = delete;
+    ModelFile & operator=(const ModelFile & model_in) = delete;
+
+    /*******************
+    * Maps a model file into memory
+    * @param  fileName_in name of the file to map
+    * @return 0  success
+    * @return -1 file could not be opened
+    * @return -2 file is not a model file of this version
+    *******************/
+    int open(std::string fileName_in);
+
+    /*******************
+    * Unmaps the current file
+    * @return 0 success
+    *******************/
+    int close();
+
+    /*******************
+    * Finds the header of the mapped file
+    * @return the header of the file
+    *******************/
+    const ModelHeader * getHeader();
+
+    /*******************
+    * Finds the bytes of a token in the lexicon
+    * @param  id_in       identifier of the token
+    * @param  length_out  location to store the number of bytes in the token
+    * @return first byte of the token
+    *******************/
+    const char * getWord(TokenId id_in, int * length_out);
+
+    /*******************
+    * Finds the stored ngrams of an order
+    * @param  index_in index of the order in the file
+    * @return the sorted ngrams of the order
+    *******************/
+    SortedNgrams getOrder(int index_in);
+
+    /*******************
+    * Finds the good turing tables of an order
+    * @param  index_in             index of the order in the file
+    * @param  frequencies_out      location to store the first (count, frequency) pair
+    * @param  numFrequencies_out   location to store the number of (count, frequency) pairs
+    * @param  probabilities_out    location to store the first (count, probability) pair
+    * @param  numProbabilities_out location to store the number of (count, probability) pairs
+    * @return 0  success
+    * @return -1 the file has no good turing tables
+    *******************/
+    int getFrequencies(int index_in, const FrequencyPair ** frequencies_out, int * numFrequencies_out,
+      const ProbabilityPair ** probabilities_out, int * numProbabilities_out);
+
+    /*******************
+    * Writes a model file
+    * @param  fileName_in      name of the file to write
+    * @param  header_in        header of the file, the offsets are filled in when writing
+    * @param  words_in         bytes of each token in the lexicon, indexed by identifier
+    * @param  orders_in        the ngrams of each order, the keys must be sorted
+    * @param  frequencies_in   (count, frequency) pairs of each order, may be empty
+    * @param  probabilities_in (count, probability) pairs of each order, may be empty
+    * @return 0  success
+    * @return -1 file could not be written
+    *******************/
+    static int write(std::string fileName_in, ModelHeader * header_in, std::vector<std::string> * words_in,
+      std::vector<SortedNgrams> * orders_in, std::vector<std::vector<FrequencyPair>> * frequencies_in,
+      std::vector<std::vector<ProbabilityPair>> * probabilities_in);
+  };
+
+  /*******************
+  * Converts a token to the bytes it is stored as in a model file
+  * @param  token_in    token to convert
+  * @param  location_in location to store the bytes
+  * @return 0 success
+  *******************/
+  inline int tokenToBytes(std::string * token_in, std::string * location_in) {
+    *location_in = *token_in;
+    return 0;
+  }
+  inline int tokenToBytes(char * token_in, std::string * location_in) {
+    location_in->assign(1, *token_in);
+    return 0;
+  }
+
+  /*******************
+  * Converts the bytes stored in a model file back to a token
+  * @param  bytes_in    first byte of the token
+  * @param  length_in   number of bytes in the token
+  * @param  location_in location to store the token
+  * @return 0 success
+  *******************/
+  inline int bytesToToken(const char * bytes_in, int length_in, std::string * location_in) {
+    location_in->assign(bytes_in, length_in);
+    return 0;
+  }
+  inline int bytesToToken(const char * bytes_in, int length_in, char * location_in) {
+    *location_in = length_in > 0 ? bytes_in[0] : '\0';
+    return 0;
+  }
+
+};
+
+#endif
@@ -0,0 +1,177 @@
+/**************************************************************
+* An open addressing hash table keyed by fixed length ngrams
+* of token identifiers
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_NGRAM_TABLE
+#define _H_NGRAM_TABLE
+
+#include <vector>  //std::vector
+#include <cstring> //memcmp()   memcpy()
+
+#include "lexicon.h"
+
+#define NGRAM_HASH_SEED 0x9E3779B97F4A7C15ull
+#define NGRAM_TABLE_MIN_CAPACITY 16
+
+namespace nlp {
+
+  /* Hash code of an ngram of token identifiers */
+  typedef unsigned long long NgramHash;
+
+  template <typename Value> class NgramTable {
+  private:
+    /* Number of token identifiers in each key */
+    int length;
+
+    /* Number of keys stored in the table */
+    int numEntries;
+
+    /* One less than the number of slots, which is always a power of 2 */
+    size_t mask;
+
+    /* Each slot holds a tag followed by the key, a tag of 0 marks an empty slot */
+    std::vector<unsigned int> slots;
+
+    /* The value for each slot */
+    std::vector<Value> values;
+
+    /*******************
+    * Finds the slot holding a key, or the empty slot it would be placed in
+    * @param  key_in  identifiers of the key to find
+    * @param  hash_in hash code of the key
+    * @return index of the slot
+    *******************/
+    size_t findSlot(const TokenId * key_in, NgramHash hash_in);
+
+    /*******************
+    * Changes the number of slots in the table and reinserts every key
+    * @param  numSlots_in new number of slots, must be a power of 2
+    * @return 0 success
+    *******************/
+    int resize(size_t numSlots_in);
+
+  public:
+    class iterator {
+    private:
+      /* The table being iterated over */
+      NgramTable * table;
+
+      /* The current slot */
+      size_t slot;
+
+    public:
+      iterator(NgramTable * table_in, size_t slot_in);
+
+      /* The identifiers of the current key */
+      const TokenId * key();
+
+      /* The value of the current key */
+      Value & value();
+
+      iterator & operator++();
+      bool operator!=(const iterator & other);
+      bool operator==(const iterator & other);
+    };
+
+    /*******************
+    * Creates a new table for keys of the specified length
+    * @param length_in number of token identifiers in each key
+    *******************/
+    NgramTable(int length_in);
+
+    //Default constructor and destructor
+    NgramTable();
+    ~NgramTable();
+
+    //Copies duplicate every slot and key of a table, such as when a document is copied, and moves hand them over
+    NgramTable(const NgramTable & table_in) = default;
+    NgramTable(NgramTable && table_in) = default;
+    NgramTable & operator=(const NgramTable & table_in) = default;
+    NgramTable & operator=(NgramTable && table_in) = default;
+
+    /*******************
+    * Adds the next identifier of an ngram to its partial hash code
+    * @param  hash_in partial hash code of the identifiers before this one
+    * @param  id_in   next identifier of the ngram
+    * @return partial hash code including the identifier
+    *******************/
+    static NgramHash hashStep(NgramHash hash_in, TokenId id_in);
+
+    /*******************
+    * Turns a partial hash code into the hash code used by the table
+    * @param  hash_in partial hash code of every identifier of the ngram
+    * @return hash code of the ngram
+    *******************/
+    static NgramHash hashFinish(NgramHash hash_in);
+
+    /*******************
+    * Computes the hash code of an ngram
+    * @param  key_in    identifiers of the ngram
+    * @param  length_in number of identifiers in the ngram
+    * @return hash code of the ngram
+    *******************/
+    static NgramHash hashKey(const TokenId * key_in, int length_in);
+
+    /*******************
+    * Finds the value stored for a key
+    * @param  key_in identifiers of the key to find
+    * @return pointer to the value of the key
+    * @return NULL key is not in the table
+    *******************/
+    Value * find(const TokenId * key_in);
+    Value * find(const TokenId * key_in, NgramHash hash_in);
+
+    /*******************
+    * Finds the value stored for a key, adding the key with a default value if it is not in the table
+    * @param  key_in identifiers of the key to find
+    * @return pointer to the value of the key
+    *******************/
+    Value * insert(const TokenId * key_in);
+    Value * insert(const TokenId * key_in, NgramHash hash_in);
+
+    /*******************
+    * Adds the value of every key in another table to the value of the key in this table
+    * @param  table_in table of the same length to add to this table
+    * @return 0 success
+    *******************/
+    int merge(NgramTable * table_in);
+
+    /*******************
+    * Grows the table so it can hold the specified number of keys without growing again
+    * @param  numEntries_in number of keys the table must be able to hold
+    * @return 0 success
+    *******************/
+    int reserve(int numEntries_in);
+
+    /*******************
+    * Finds the number of keys in the table
+    * @return number of keys in the table
+    *******************/
+    int size();
+
+    /*******************
+    * Finds the number of identifiers in each key
+    * @return length of the keys
+    *******************/
+    int getLength();
+
+    /*******************
+    * Finds the number of bytes used by the slots of the table
+    * @return bytes used by the table
+    *******************/
+    size_t memoryUsage();
+
+    iterator begin();
+    iterator end();
+  };
+
+};
+
+#endif
@@ -0,0 +1,224 @@
+//An open addressing hash table keyed by fixed length ngrams of token identifiers
+
+#ifndef _T_NGRAM_TABLE
+#define _T_NGRAM_TABLE
+
+#include "ngram_table.h"
+
+namespace nlp {
+
+  //Adds the next identifier of an ngram to its partial hash code
+  template <typename Value> NgramHash NgramTable<Value>::hashStep(NgramHash hash_in, TokenId id_in) {
+    return (hash_in ^ (NgramHash) id_in) * 0xFF51AFD7ED558CCDull;
+  }
+
+  //Turns a partial hash code into the hash code used by the table
+  template <typename Value> NgramHash NgramTable<Value>::hashFinish(NgramHash hash_in) {
+    hash_in ^= hash_in >> 33;
+    hash_in *= 0xC4CEB9FE1A85EC53ull;
+    hash_in ^= hash_in >> 33;
+    return hash_in;
+  }
+
+  //Computes the hash code of an ngram
+  template <typename Value> NgramHash NgramTable<Value>::hashKey(const TokenId * key_in, int length_in) {
+    NgramHash result;
+    int keyIterator;
+
+    result = NGRAM_HASH_SEED;
+    for (keyIterator = 0; keyIterator < length_in; ++keyIterator) {
+      result = hashStep(result, key_in[keyIterator]);
+    }
+
+    return hashFinish(result);
+  }
+
+  //Finds the slot holding a key, or the empty slot it would be placed in
+  template <typename Value> size_t NgramTable<Value>::findSlot(const TokenId * key_in, NgramHash hash_in) {
+    unsigned int tag;
+    unsigned int * current;
+    size_t slot;
+
+    //The low bits pick the first slot so the high bits are used to filter comparisons
+    tag = ((unsigned int) (hash_in >> 32)) | 1;
+    slot = hash_in & mask;
+
+    while (true) {
+      current = &slots[slot * (length + 1)];
+      //Stop at the first empty slot or the slot holding the key
+      if (current[0] == 0) {
+        return slot;
+      }
+      if (current[0] == tag && memcmp(current + 1, key_in, length * sizeof(TokenId)) == 0) {
+        return slot;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  //Changes the number of slots in the table and reinserts every key
+  template <typename Value> int NgramTable<Value>::resize(size_t numSlots_in) {
+    std::vector<unsigned int> oldSlots;
+    std::vector<Value> oldValues;
+    size_t slotIterator;
+    size_t slot;
+    unsigned int * current;
+    NgramHash hash;
+
+    oldSlots.swap(slots);
+    oldValues.swap(values);
+    mask = numSlots_in - 1;
+    slots.assign((mask + 1) * (length + 1), 0);
+    values.resize(mask + 1);
+
+    for (slotIterator = 0; slotIterator < oldValues.size(); ++slotIterator) {
+      current = &oldSlots[slotIterator * (length + 1)];
+      if (current[0] == 0) {
+        continue;
+      }
+      hash = hashKey(current + 1, length);
+      slot = findSlot(current + 1, hash);
+      memcpy(&slots[slot * (length + 1)], current, (length + 1) * sizeof(unsigned int));
+      values[slot] = oldValues[slotIterator];
+    }
+
+    return 0;
+  }
+
+  //Finds the value stored for a key
+  template <typename Value> Value * NgramTable<Value>::find(const TokenId * key_in) {
+    return find(key_in, hashKey(key_in, length));
+  }
+
+  //Finds the value stored for a key
+  template <typename Value> Value * NgramTable<Value>::find(const TokenId * key_in, NgramHash hash_in) {
+    size_t slot;
+
+    slot = findSlot(key_in, hash_in);
+    return slots[slot * (length + 1)] == 0 ? NULL : &values[slot];
+  }
+
+  //Finds the value stored for a key, adding the key with a default value if it is not in the table
+  template <typename Value> Value * NgramTable<Value>::insert(const TokenId * key_in) {
+    return insert(key_in, hashKey(key_in, length));
+  }
+
+  //Finds the value stored for a key, adding the key with a default value if it is not in the table
+  template <typename Value> Value * NgramTable<Value>::insert(const TokenId * key_in, NgramHash hash_in) {
+    size_t slot;
+    unsigned int * current;
+
+    //Keep the table at most three quarters full so probe sequences stay short
+    if ((size_t) (numEntries + 1) * 4 > (mask + 1) * 3) {
+      resize((mask + 1) * 2);
+    }
+
+    slot = findSlot(key_in, hash_in);
+    current = &slots[slot * (length + 1)];
+    if (current[0] == 0) {
+      current[0] = ((unsigned int) (hash_in >> 32)) | 1;
+      memcpy(current + 1, key_in, length * sizeof(TokenId));
+      values[slot] = Value();
+      ++numEntries;
+    }
+
+    return &values[slot];
+  }
+
+  //Adds the value of every key in another table to the value of the key in this table
+  template <typename Value> int NgramTable<Value>::merge(NgramTable * table_in) {
+    reserve(numEntries + table_in->size());
+    for (auto iterator = table_in->begin(); iterator != table_in->end(); ++iterator) {
+      *insert(iterator.key()) += iterator.value();
+    }
+
+    return 0;
+  }
+
+  //Grows the table so it can hold the specified number of keys without growing again
+  template <typename Value> int NgramTable<Value>::reserve(int numEntries_in) {
+    size_t numSlots;
+
+    numSlots = mask + 1;
+    while ((size_t) numEntries_in * 4 > numSlots * 3) {
+      numSlots = numSlots * 2;
+    }
+    if (numSlots != mask + 1) {
+      resize(numSlots);
+    }
+
+    return 0;
+  }
+
+  //Finds the number of keys in the table
+  template <typename Value> int NgramTable<Value>::size() {
+    return numEntries;
+  }
+
+  //Finds the number of identifiers in each key
+  template <typename Value> int NgramTable<Value>::getLength() {
+    return length;
+  }
+
+  //Finds the number of bytes used by the slots of the table
+  template <typename Value> size_t NgramTable<Value>::memoryUsage() {
+    return slots.size() * sizeof(unsigned int) + values.size() * sizeof(Value);
+  }
+
+  template <typename Value> typename NgramTable<Value>::iterator NgramTable<Value>::begin() {
+    return iterator(this, 0);
+  }
+
+  template <typename Value> typename NgramTable<Value>::iterator NgramTable<Value>::end() {
+    return iterator(this, mask + 1);
+  }
+
+  //Creates a new table for keys of the specified length
+  template <typename Value> NgramTable<Value>::NgramTable(int length_in) {
+    length = length_in;
+    numEntries = 0;
+    mask = NGRAM_TABLE_MIN_CAPACITY - 1;
+    slots.assign((mask + 1) * (length + 1), 0);
+    values.resize(mask + 1);
+  }
+
+  //Default constructor and destructor
+  template <typename Value> NgramTable<Value>::NgramTable() :NgramTable(0) {}
+  template <typename Value> NgramTable<Value>::~NgramTable() {}
+
+  //Creates an iterator starting at the first key at or after the specified slot
+  template <typename Value> NgramTable<Value>::iterator::iterator(NgramTable * table_in, size_t slot_in) {
+    table = table_in;
+    slot = slot_in;
+    while (slot <= table->mask && table->slots[slot * (table->length + 1)] == 0) {
+      ++slot;
+    }
+  }
+
+  template <typename Value> const TokenId * NgramTable<Value>::iterator::key() {
+    return &table->slots[slot * (table->length + 1) + 1];
+  }
+
+  template <typename Value> Value & NgramTable<Value>::iterator::value() {
+    return table->values[slot];
+  }
+
+  template <typename Value> typename NgramTable<Value>::iterator & NgramTable<Value>::iterator::operator++() {
+    ++slot;
+    while (slot <= table->mask && table->slots[slot * (table->length + 1)] == 0) {
+      ++slot;
+    }
+    return *this;
+  }
+
+  template <typename Value> bool NgramTable<Value>::iterator::operator!=(const iterator & other) {
+    return slot != other.slot;
+  }
+
+  template <typename Value> bool NgramTable<Value>::iterator::operator==(const iterator & other) {
+    return slot == other.slot;
+  }
+
+};
+
+#endif
@@ -0,0 +1,76 @@
+//An array of unsigned numbers that all use the same number of bits, packed one after another into 64 bit words
+
+#include "packed_array.h"
+
+namespace nlp {
+
+  //Finds the number of bits needed to store a number
+  int PackedArray::bitsNeeded(unsigned int number_in) {
+    int result;
+
+    result = 1;
+    while (result < 32 && (number_in >> result) != 0) {
+      ++result;
+    }
+
+    return result;
+  }
+
+  //Packs numbers into the array
+  int PackedArray::assign(std::vector<unsigned int> * numbers_in, int numBits_in) {
+    unsigned long long position;
+    size_t numberIterator;
+    int offset;
+
+    numBits = numBits_in < 1 ? 1 : (numBits_in > 32 ? 32 : numBits_in);
+    numEntries = numbers_in->size();
+    words.assign((numEntries * numBits + 63) / 64 + 1, 0);
+
+    for (numberIterator = 0; numberIterator < numEntries; ++numberIterator) {
+      position = (unsigned long long) numberIterator * numBits;
+      offset = (int) (position % 64);
+      words[position / 64] |= (unsigned long long) (*numbers_in)[numberIterator] << offset;
+      //A number that crosses into the next word puts its high bits at the start of it
+      if (offset + numBits > 64) {
+        words[position / 64 + 1] |= (unsigned long long) (*numbers_in)[numberIterator] >> (64 - offset);
+      }
+    }
+
+    return 0;
+  }
+
+  //Finds a stored number
+  unsigned int PackedArray::get(size_t index_in) {
+    unsigned long long position;
+    unsigned long long result;
+    int offset;
+
+    position = (unsigned long long) index_in * numBits;
+    offset = (int) (position % 64);
+    result = words[position / 64] >> offset;
+    if (offset + numBits > 64) {
+      result |= words[position / 64 + 1] << (64 - offset);
+    }
+
+    return (unsigned int) (result & ((1ull << numBits) - 1));
+  }
+
+  //Finds the number of numbers stored
+  size_t PackedArray::size() {
+    return numEntries;
+  }
+
+  //Finds the number of bits each number uses
+  int PackedArray::getBits() {
+    return numBits;
+  }
+
+  //Finds the number of bytes used by the words of the array
+  size_t PackedArray::memoryUsage() {
+    return words.capacity() * sizeof(unsigned long long);
+  }
+
+  //Default constructor and destructor
+  PackedArray::PackedArray() :numBits(1), numEntries(0) {}
+  PackedArray::~PackedArray() {}
+};
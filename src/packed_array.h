@@ -0,0 +1,79 @@
+/**************************************************************
+* An array of unsigned numbers that all use the same number
+* of bits, packed one after another into 64 bit words
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_PACKED_ARRAY
+#define _H_PACKED_ARRAY
+
+#include <vector>  //std::vector
+#include <cstddef> //size_t
+
+namespace nlp {
+
+  class PackedArray {
+  private:
+    /* Bits of every number one after another, with a word past the last so reads never check the end */
+    std::vector<unsigned long long> words;
+
+    /* Number of bits each number uses */
+    int numBits;
+
+    /* Number of numbers stored */
+    size_t numEntries;
+
+  public:
+    //Default constructor and destructor
+    PackedArray();
+    ~PackedArray();
+
+    /*******************
+    * Finds the number of bits needed to store a number
+    * @param  number_in number to store
+    * @return number of bits, at least 1
+    *******************/
+    static int bitsNeeded(unsigned int number_in);
+
+    /*******************
+    * Packs numbers into the array, replacing anything stored
+    * @param  numbers_in numbers to pack
+    * @param  numBits_in number of bits each number uses, every number has to fit in it
+    * @return 0 success
+    *******************/
+    int assign(std::vector<unsigned int> * numbers_in, int numBits_in);
+
+    /*******************
+    * Finds a stored number
+    * @param  index_in index of the number
+    * @return the number
+    *******************/
+    unsigned int get(size_t index_in);
+
+    /*******************
+    * Finds the number of numbers stored
+    * @return number of numbers
+    *******************/
+    size_t size();
+
+    /*******************
+    * Finds the number of bits each number uses
+    * @return number of bits
+    *******************/
+    int getBits();
+
+    /*******************
+    * Finds the number of bytes used by the words of the array
+    * @return bytes used by the array
+    *******************/
+    size_t memoryUsage();
+  };
+
+};
+
+#endif
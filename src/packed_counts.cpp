@@ -0,0 +1,85 @@
+//A read only array of counts where the counts of 1 take a single bit and the rest are packed into as few bits as the largest of them needs
+
+#include "packed_counts.h"
+
+namespace nlp {
+
+  //Packs counts into the array
+  int PackedCounts::assign(std::vector<unsigned int> * counts_in) {
+    std::vector<unsigned int> rest;
+    unsigned long long numBefore;
+    unsigned int largest;
+    size_t countIterator;
+    size_t position;
+    size_t numBlocks;
+    size_t address;
+
+    numEntries = counts_in->size();
+    numBlocks = (numEntries + (PACKED_BLOCK_WORDS - 1) * 64 - 1) / ((PACKED_BLOCK_WORDS - 1) * 64);
+    singletons.assign(numBlocks * PACKED_BLOCK_WORDS + PACKED_LINE_BYTES / sizeof(unsigned long long), 0);
+    //Blocks start on a cache line so the bits and the number before them are read together
+    address = (size_t) singletons.data();
+    offset = ((PACKED_LINE_BYTES - address % PACKED_LINE_BYTES) % PACKED_LINE_BYTES) / sizeof(unsigned long long);
+
+    numBefore = 0;
+    largest = 0;
+    for (countIterator = 0; countIterator < numEntries; ++countIterator) {
+      position = countIterator % ((PACKED_BLOCK_WORDS - 1) * 64);
+      if (position == 0) {
+        singletons[offset + countIterator / ((PACKED_BLOCK_WORDS - 1) * 64) * PACKED_BLOCK_WORDS] = numBefore;
+      }
+      if ((*counts_in)[countIterator] == 1) {
+        singletons[offset + countIterator / ((PACKED_BLOCK_WORDS - 1) * 64) * PACKED_BLOCK_WORDS + 1 + position / 64] |= 1ull << (position % 64);
+        ++numBefore;
+        continue;
+      }
+      rest.push_back((*counts_in)[countIterator]);
+      largest = (*counts_in)[countIterator] > largest ? (*counts_in)[countIterator] : largest;
+    }
+    others.assign(&rest, PackedArray::bitsNeeded(largest));
+
+    return 0;
+  }
+
+  //Finds a stored count
+  unsigned int PackedCounts::get(size_t index_in) {
+    const unsigned long long * block;
+    unsigned long long numBefore;
+    size_t position;
+    size_t wordIterator;
+
+    block = &singletons[offset + index_in / ((PACKED_BLOCK_WORDS - 1) * 64) * PACKED_BLOCK_WORDS];
+    position = index_in % ((PACKED_BLOCK_WORDS - 1) * 64);
+    if ((block[1 + position / 64] >> (position % 64)) & 1) {
+      return 1;
+    }
+
+    //The other counts are found by the number of counts of 1 before this one
+    numBefore = block[0];
+    for (wordIterator = 0; wordIterator < position / 64; ++wordIterator) {
+      numBefore += std::bitset<64>(block[1 + wordIterator]).count();
+    }
+    numBefore += std::bitset<64>(block[1 + position / 64] & ((1ull << (position % 64)) - 1)).count();
+
+    return others.get(index_in - numBefore);
+  }
+
+  //Finds the number of counts stored
+  size_t PackedCounts::size() {
+    return numEntries;
+  }
+
+  //Finds the number of bits each count that is not 1 uses
+  int PackedCounts::getBits() {
+    return others.getBits();
+  }
+
+  //Finds the number of bytes used by the blocks and the other counts
+  size_t PackedCounts::memoryUsage() {
+    return singletons.capacity() * sizeof(unsigned long long) + others.memoryUsage();
+  }
+
+  //Default constructor and destructor
+  PackedCounts::PackedCounts() :offset(0), numEntries(0) {}
+  PackedCounts::~PackedCounts() {}
+};
@@ -0,0 +1,82 @@
+/**************************************************************
+* A read only array of counts where the counts of 1 take a
+* single bit and the rest are packed into as few bits as the
+* largest of them needs
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_PACKED_COUNTS
+#define _H_PACKED_COUNTS
+
+#include <vector>  //std::vector
+#include <bitset>  //std::bitset
+#include <cstddef> //size_t
+
+#include "packed_array.h"
+
+#define PACKED_BLOCK_WORDS 8
+#define PACKED_LINE_BYTES 64
+
+namespace nlp {
+
+  class PackedCounts {
+  private:
+    /* Blocks of PACKED_BLOCK_WORDS words with room to start the first block on a cache line. The first word of a
+       block holds the number of counts of 1 before it and the others have a bit set for each count of 1 in it */
+    std::vector<unsigned long long> singletons;
+
+    /* Index in singletons of the first word of the first block */
+    size_t offset;
+
+    /* Every count that is not 1 in order */
+    PackedArray others;
+
+    /* Number of counts stored */
+    size_t numEntries;
+
+  public:
+    //Default constructor and destructor
+    PackedCounts();
+    ~PackedCounts();
+
+    /*******************
+    * Packs counts into the array, replacing anything stored
+    * @param  counts_in counts to pack
+    * @return 0 success
+    *******************/
+    int assign(std::vector<unsigned int> * counts_in);
+
+    /*******************
+    * Finds a stored count. A count of 1 is found from one cache line, the others from two
+    * @param  index_in index of the count
+    * @return the count
+    *******************/
+    unsigned int get(size_t index_in);
+
+    /*******************
+    * Finds the number of counts stored
+    * @return number of counts
+    *******************/
+    size_t size();
+
+    /*******************
+    * Finds the number of bits each count that is not 1 uses
+    * @return number of bits
+    *******************/
+    int getBits();
+
+    /*******************
+    * Finds the number of bytes used by the blocks and the other counts
+    * @return bytes used by the array
+    *******************/
+    size_t memoryUsage();
+  };
+
+};
+
+#endif
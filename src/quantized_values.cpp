@@ -0,0 +1,70 @@
+//A read only array of real numbers each stored as the code of one of a few bins, with the mean of every bin kept in a table
+
+#include "quantized_values.h"
+
+namespace nlp {
+
+  //Splits values into bins that each hold about as many of them, and stores the bin of each
+  int QuantizedValues::assign(std::vector<float> * values_in, int numBits_in) {
+    std::vector<float> sorted;
+    std::vector<float> starts;
+    std::vector<double> sums;
+    std::vector<size_t> sizes;
+    std::vector<unsigned int> binCodes;
+    size_t numBins;
+    size_t binIterator;
+    size_t valueIterator;
+    unsigned int code;
+
+    numBits_in = numBits_in < 1 ? 1 : (numBits_in > QUANTIZED_MAX_BITS ? QUANTIZED_MAX_BITS : numBits_in);
+    sorted = *values_in;
+    std::sort(sorted.begin(), sorted.end());
+    numBins = (size_t) 1 << numBits_in;
+    numBins = sorted.size() < numBins ? sorted.size() : numBins;
+
+    //Each bin starts at the value its share of the sorted values starts at, equal values share a bin
+    for (binIterator = 0; binIterator < numBins; ++binIterator) {
+      starts.push_back(sorted[binIterator * sorted.size() / numBins]);
+    }
+    //A value common enough to fill several shares only needs one bin
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    numBins = starts.size();
+    sums.assign(numBins, 0);
+    sizes.assign(numBins, 0);
+    binCodes.reserve(values_in->size());
+    for (valueIterator = 0; valueIterator < values_in->size(); ++valueIterator) {
+      //The first start is the smallest value so every value is at or past it
+      code = (unsigned int) (std::upper_bound(starts.begin(), starts.end(), (*values_in)[valueIterator]) - starts.begin()) - 1;
+      sums[code] += (*values_in)[valueIterator];
+      ++sizes[code];
+      binCodes.push_back(code);
+    }
+
+    centers.assign(numBins, 0);
+    for (binIterator = 0; binIterator < numBins; ++binIterator) {
+      centers[binIterator] = sizes[binIterator] == 0 ? starts[binIterator] : (float) (sums[binIterator] / sizes[binIterator]);
+    }
+    codes.assign(&binCodes, numBits_in);
+
+    return 0;
+  }
+
+  //Finds a stored value
+  float QuantizedValues::get(size_t index_in) {
+    return centers[codes.get(index_in)];
+  }
+
+  //Finds the number of values stored
+  size_t QuantizedValues::size() {
+    return codes.size();
+  }
+
+  //Finds the number of bytes used by the codes and the table of bins
+  size_t QuantizedValues::memoryUsage() {
+    return codes.memoryUsage() + centers.capacity() * sizeof(float);
+  }
+
+  //Default constructor and destructor
+  QuantizedValues::QuantizedValues() {}
+  QuantizedValues::~QuantizedValues() {}
+};
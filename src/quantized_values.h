@@ -0,0 +1,69 @@
+/**************************************************************
+* A read only array of real numbers each stored as the code of
+* one of a few bins, with the mean of every bin kept in a table
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_QUANTIZED_VALUES
+#define _H_QUANTIZED_VALUES
+
+#include <vector>    //std::vector
+#include <algorithm> //std::sort()   std::unique()   std::upper_bound()
+#include <cstddef>   //size_t
+
+#include "packed_array.h"
+
+#define QUANTIZED_MAX_BITS 16
+
+namespace nlp {
+
+  class QuantizedValues {
+  private:
+    /* Mean of the values in each bin, indexed by code */
+    std::vector<float> centers;
+
+    /* Code of the bin of every value in order */
+    PackedArray codes;
+
+  public:
+    //Default constructor and destructor
+    QuantizedValues();
+    ~QuantizedValues();
+
+    /*******************
+    * Splits values into bins that each hold about as many of them, and stores the bin of each.
+    * Bins are narrow where values are common so the error is lowest for the most common values
+    * @param  values_in values to store
+    * @param  numBits_in number of bits of each code, from 1 to QUANTIZED_MAX_BITS
+    * @return 0 success
+    *******************/
+    int assign(std::vector<float> * values_in, int numBits_in);
+
+    /*******************
+    * Finds a stored value
+    * @param  index_in index of the value
+    * @return mean of the bin the value is in
+    *******************/
+    float get(size_t index_in);
+
+    /*******************
+    * Finds the number of values stored
+    * @return number of values
+    *******************/
+    size_t size();
+
+    /*******************
+    * Finds the number of bytes used by the codes and the table of bins
+    * @return bytes used by the values
+    *******************/
+    size_t memoryUsage();
+  };
+
+};
+
+#endif
@@ -0,0 +1,87 @@
+/**************************************************************
+* The state of a language model part way through a sentence,
+* which can be advanced one token at a time and copied to
+* extend many sentences from a shared beginning
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_SCORER_STATE
+#define _H_SCORER_STATE
+
+#include <cstring> //memmove()
+
+#include "lexicon.h"
+
+#define SCORER_MAX_LENGTH 16
+
+namespace nlp {
+
+  /* Context of the next token and the score of the tokens so far. The context is
+     held in place so it is never allocated, copying a state copies the whole sentence so far */
+  struct ScorerState {
+    /* Identifiers of the tokens before the next one, oldest first, with room for the next token after them */
+    TokenId context[SCORER_MAX_LENGTH];
+
+    /* Number of identifiers in the context */
+    int contextLength;
+
+    /* Number of tokens scored so far */
+    int numTokens;
+
+    /* Natural log of the probability of the tokens scored so far */
+    double logProbability;
+  };
+
+  /*******************
+  * Empties a state so it is at the start of a sentence
+  * @param  state_in state to empty
+  * @return 0 success
+  *******************/
+  inline int resetState(ScorerState * state_in) {
+    state_in->contextLength = 0;
+    state_in->numTokens = 0;
+    state_in->logProbability = 0;
+    return 0;
+  }
+
+  /*******************
+  * Drops the oldest identifiers of a state's context so the next token and its context
+  * make an ngram of at most the specified length. Lengths past SCORER_MAX_LENGTH are cut to it
+  * @param  state_in  state to trim
+  * @param  length_in length of ngrams the next token is scored with
+  * @return 0 success
+  *******************/
+  inline int trimState(ScorerState * state_in, int length_in) {
+    int excess;
+
+    length_in = length_in > SCORER_MAX_LENGTH ? SCORER_MAX_LENGTH : (length_in < 1 ? 1 : length_in);
+    excess = state_in->contextLength - (length_in - 1);
+    if (excess > 0) {
+      memmove(state_in->context, state_in->context + excess, (length_in - 1) * sizeof(TokenId));
+      state_in->contextLength = length_in - 1;
+    }
+    return 0;
+  }
+
+  /*******************
+  * Adds the token stored just after a state's context to the context along with its score
+  * @param  state_in          state to advance
+  * @param  length_in         length of ngrams the token was scored with
+  * @param  logProbability_in natural log of the probability of the token
+  * @return 0 success
+  *******************/
+  inline int acceptState(ScorerState * state_in, int length_in, double logProbability_in) {
+    ++state_in->contextLength;
+    ++state_in->numTokens;
+    state_in->logProbability += logProbability_in;
+    return trimState(state_in, length_in);
+  }
+
+};
+
+#endif
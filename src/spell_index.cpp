@@ -0,0 +1,208 @@
+//A symmetric delete index of the unigram vocabulary of a document that finds every word within a small edit distance of a misspelled token
+
+#include <algorithm> //std::sort()   std::unique()   std::lower_bound()
+#include <cmath>     //log()
+
+#include "spell_index.h"
+#include "../Ngrams/utilsToStudents.h"
+
+namespace nlp {
+
+  //Finds the hash of a string
+  unsigned long long SpellIndex::hashString(const std::string * string_in) {
+    unsigned long long result;
+    size_t characterIterator;
+
+    result = 0xCBF29CE484222325ull;
+    for (characterIterator = 0; characterIterator < string_in->size(); ++characterIterator) {
+      result = (result ^ (unsigned char) (*string_in)[characterIterator]) * 0x100000001B3ull;
+    }
+    //The upper bits are kept so they are mixed with every character
+    result ^= result >> 29;
+    result *= 0xBF58476D1CE4E5B9ull;
+    result ^= result >> 32;
+
+    return result;
+  }
+
+  //Adds the hash of a string and of every string made by deleting characters from it
+  int SpellIndex::addDeletes(std::string * string_in, int start_in, int distance_in, std::vector<unsigned long long> * location_in) {
+    std::string shorter;
+    int positionIterator;
+
+    location_in->push_back(hashString(string_in));
+    if (distance_in == 0) {
+      return 0;
+    }
+    for (positionIterator = start_in; positionIterator < (int) string_in->size(); ++positionIterator) {
+      shorter = *string_in;
+      shorter.erase(positionIterator, 1);
+      addDeletes(&shorter, positionIterator, distance_in - 1, location_in);
+    }
+
+    return 0;
+  }
+
+  //Finds the words sharing a delete with a token
+  int SpellIndex::findWords(std::string * token_in, int distance_in, std::vector<int> * location_in) {
+    std::vector<unsigned long long> hashes;
+    std::string prefix;
+    unsigned long long wordMask;
+    size_t hashIterator;
+
+    location_in->clear();
+    prefix = prefixLength > 0 && (int) token_in->size() > prefixLength ? token_in->substr(0, prefixLength) : *token_in;
+    addDeletes(&prefix, 0, distance_in, &hashes);
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    //Every entry with the same upper bits as a delete belongs to a word sharing it
+    wordMask = (1ull << wordBits) - 1;
+    for (hashIterator = 0; hashIterator < hashes.size(); ++hashIterator) {
+      unsigned long long upper = hashes[hashIterator] & ~wordMask;
+      auto entry = std::lower_bound(deletes.begin(), deletes.end(), upper);
+      for (; entry != deletes.end() && (*entry & ~wordMask) == upper; ++entry) {
+        location_in->push_back((int) (*entry & wordMask));
+      }
+    }
+    std::sort(location_in->begin(), location_in->end());
+    location_in->erase(std::unique(location_in->begin(), location_in->end()), location_in->end());
+
+    return 0;
+  }
+
+  //Finds every word within an edit distance of a token
+  int SpellIndex::lookup(std::string * token_in, int distance_in, std::vector<SpellCandidate> * location_in) {
+    std::vector<int> found;
+    size_t wordIterator;
+    size_t distance;
+
+    location_in->clear();
+    if (distance_in > maxDistance) {
+      return -1;
+    }
+
+    //Sharing a delete does not mean being close, so each word is checked with the bounded distance
+    findWords(token_in, distance_in, &found);
+    for (wordIterator = 0; wordIterator < found.size(); ++wordIterator) {
+      distance = uiLevenshteinDistanceBounded(*token_in, words[found[wordIterator]], distance_in);
+      if (distance <= (size_t) distance_in) {
+        SpellCandidate candidate;
+        candidate.word = words[found[wordIterator]];
+        candidate.distance = distance;
+        candidate.count = counts[found[wordIterator]];
+        candidate.score = 0;
+        location_in->push_back(candidate);
+      }
+    }
+    std::sort(location_in->begin(), location_in->end(), [](const SpellCandidate & first_in, const SpellCandidate & second_in) {
+      if (first_in.count != second_in.count) {
+        return first_in.count > second_in.count;
+      }
+      if (first_in.distance != second_in.distance) {
+        return first_in.distance < second_in.distance;
+      }
+      return first_in.word < second_in.word;
+    });
+
+    return 0;
+  }
+
+  //Ranks the words within the index's edit distance of a token by how likely they are to follow the token before it
+  int SpellIndex::correct(std::string * previous_in, std::string * token_in, MLDocument<std::string> * model_in, double editPenalty_in,
+    std::vector<SpellCandidate> * location_in) {
+    size_t candidateIterator;
+    double unigram;
+    double bigram;
+
+    lookup(token_in, maxDistance, location_in);
+    for (candidateIterator = 0; candidateIterator < location_in->size(); ++candidateIterator) {
+      SpellCandidate & candidate = (*location_in)[candidateIterator];
+      unigram = totalCount > 0 ? (double) candidate.count / totalCount : 0;
+      bigram = previous_in == NULL ? unigram : model_in->probabilityGiven(previous_in, 1, &candidate.word, 1);
+      candidate.score = log((1 - SPELL_UNIGRAM_WEIGHT) * bigram + SPELL_UNIGRAM_WEIGHT * unigram) - editPenalty_in * candidate.distance;
+    }
+    std::stable_sort(location_in->begin(), location_in->end(), [](const SpellCandidate & first_in, const SpellCandidate & second_in) {
+      return first_in.score > second_in.score;
+    });
+
+    return 0;
+  }
+
+  //Finds the number of words in the index
+  int SpellIndex::size() {
+    return words.size();
+  }
+
+  //Finds the number of bytes used by the deletes of every word
+  size_t SpellIndex::memoryUsage() {
+    return deletes.capacity() * sizeof(unsigned long long);
+  }
+
+  //Initilizes the index from the unigrams of a document
+  int SpellIndex::init_object(Document<std::string> * document_in, int maxDistance_in, int prefixLength_in) {
+    Lexicon<std::string> * lexicon;
+    std::vector<unsigned long long> hashes;
+    std::string prefix;
+    std::string eos;
+    TokenId tokenIterator;
+    size_t hashIterator;
+    int count;
+    int wordIterator;
+
+    maxDistance = maxDistance_in;
+    prefixLength = prefixLength_in;
+    totalCount = 0;
+    eos = EOS;
+
+    lexicon = document_in->getLexicon();
+    for (tokenIterator = 0; tokenIterator < (TokenId) lexicon->size(); ++tokenIterator) {
+      std::string * token = lexicon->getToken(tokenIterator);
+      count = document_in->countNgram(token, 1);
+      if (count > 0 && *token != eos) {
+        words.push_back(*token);
+        counts.push_back(count);
+        totalCount += count;
+      }
+    }
+
+    //The index of the word takes the low bits of each entry, the hash of the delete the rest
+    wordBits = 1;
+    while ((1ull << wordBits) < words.size()) {
+      ++wordBits;
+    }
+    for (wordIterator = 0; wordIterator < (int) words.size(); ++wordIterator) {
+      prefix = prefixLength > 0 && (int) words[wordIterator].size() > prefixLength ? words[wordIterator].substr(0, prefixLength) : words[wordIterator];
+      hashes.clear();
+      addDeletes(&prefix, 0, maxDistance, &hashes);
+      std::sort(hashes.begin(), hashes.end());
+      hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+      for (hashIterator = 0; hashIterator < hashes.size(); ++hashIterator) {
+        deletes.push_back((hashes[hashIterator] & ~((1ull << wordBits) - 1)) | (unsigned long long) wordIterator);
+      }
+    }
+    std::sort(deletes.begin(), deletes.end());
+    deletes.shrink_to_fit();
+
+    return 0;
+  }
+
+  //Creates an index of every token the document counted as a unigram
+  SpellIndex::SpellIndex(Document<std::string> * document_in, int maxDistance_in, int prefixLength_in) {
+    init_object(document_in, maxDistance_in, prefixLength_in);
+  }
+
+  //Creates an index using SPELL_PREFIX_LENGTH leading characters of each word
+  SpellIndex::SpellIndex(Document<std::string> * document_in, int maxDistance_in) {
+    init_object(document_in, maxDistance_in, SPELL_PREFIX_LENGTH);
+  }
+
+  //Default constructor and destructor
+  SpellIndex::SpellIndex() {
+    maxDistance = 0;
+    prefixLength = 0;
+    totalCount = 0;
+    wordBits = 1;
+  }
+  SpellIndex::~SpellIndex() {}
+};
@@ -0,0 +1,157 @@
+/**************************************************************
+* A symmetric delete index of the unigram vocabulary of a
+* document that finds every word within a small edit distance
+* of a misspelled token
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_SPELL_INDEX
+#define _H_SPELL_INDEX
+
+#include <string> //std::string
+#include <vector> //std::vector
+
+#include "ml_document.t.h"
+
+#define SPELL_PREFIX_LENGTH 7
+#define SPELL_UNIGRAM_WEIGHT 0.1
+
+namespace nlp {
+
+  /* A vocabulary word close to a token */
+  struct SpellCandidate {
+    /* The word */
+    std::string word;
+
+    /* Edit distance from the token to the word */
+    int distance;
+
+    /* Occurances of the word in the document the index was built from */
+    int count;
+
+    /* Natural log score given by SpellIndex::correct, 0 from SpellIndex::lookup */
+    double score;
+  };
+
+  class SpellIndex {
+  private:
+    /* Largest edit distance the index can find words within */
+    int maxDistance;
+
+    /* Number of leading characters of each word that deletes are made from */
+    int prefixLength;
+
+    /* Every word of the vocabulary and its count */
+    std::vector<std::string> words;
+    std::vector<int> counts;
+
+    /* Sum of the counts of every word */
+    long long totalCount;
+
+    /* Bits of each entry of deletes that hold the word's index */
+    int wordBits;
+
+    /* Every string made by deleting up to maxDistance characters from the prefix of a word. Each entry
+       is the upper bits of the hash of the string above the index of the word, sorted */
+    std::vector<unsigned long long> deletes;
+
+    /*******************
+    * Finds the hash of a string
+    * @param  string_in string to hash
+    * @return hash of the string
+    *******************/
+    static unsigned long long hashString(const std::string * string_in);
+
+    /*******************
+    * Adds the hash of a string and of every string made by deleting characters from it
+    * @param  string_in   string to delete characters from
+    * @param  start_in    first position that may be deleted, so each set of positions is deleted once
+    * @param  distance_in most characters left to delete
+    * @param  location_in location to append the hashes to
+    * @return 0 success
+    *******************/
+    static int addDeletes(std::string * string_in, int start_in, int distance_in, std::vector<unsigned long long> * location_in);
+
+    /*******************
+    * Finds the words sharing a delete with a token, which include every word within maxDistance
+    * @param  token_in    token to find the words of
+    * @param  distance_in most characters deleted from the token
+    * @param  location_in location to store the indexes of the words, sorted
+    * @return 0 success
+    *******************/
+    int findWords(std::string * token_in, int distance_in, std::vector<int> * location_in);
+
+    /*******************
+    * Initilizes the index from the unigrams of a document
+    * @param document_in     document to take the vocabulary from
+    * @param maxDistance_in  largest edit distance lookups can ask for
+    * @param prefixLength_in number of leading characters deletes are made from, 0 uses whole words
+    *******************/
+    int init_object(Document<std::string> * document_in, int maxDistance_in, int prefixLength_in);
+
+  public:
+    /*******************
+    * Creates an index of every token the document counted as a unigram, other than the end of sentence token
+    * @param document_in    document to take the vocabulary from, it has to have read length 1
+    * @param maxDistance_in largest edit distance lookups can ask for
+    * @param prefixLength_in number of leading characters deletes are made from, fewer saves memory
+    *                        but checks more words that share a prefix. 0 uses whole words
+    *******************/
+    SpellIndex(Document<std::string> * document_in, int maxDistance_in, int prefixLength_in);
+
+    /*******************
+    * Creates an index using SPELL_PREFIX_LENGTH leading characters of each word
+    * @param document_in    document to take the vocabulary from, it has to have read length 1
+    * @param maxDistance_in largest edit distance lookups can ask for
+    *******************/
+    SpellIndex(Document<std::string> * document_in, int maxDistance_in);
+
+    //Default constructor and destructor
+    SpellIndex();
+    ~SpellIndex();
+
+    /*******************
+    * Finds every word within an edit distance of a token
+    * @param  token_in    token to find the words near
+    * @param  distance_in largest edit distance to find, no more than the index was built for
+    * @param  location_in location to store the words, most frequent first and closest first among equal counts
+    * @return 0  success
+    * @return -1 the distance is more than the index was built for
+    *******************/
+    int lookup(std::string * token_in, int distance_in, std::vector<SpellCandidate> * location_in);
+
+    /*******************
+    * Ranks the words within the index's edit distance of a token by how likely they are to follow the
+    * token before it. The probability of each word given the previous token is interpolated with its
+    * unigram probability by SPELL_UNIGRAM_WEIGHT, so words never seen after the previous token still rank
+    * @param  previous_in   token before the one to correct, NULL at the start of a sentence
+    * @param  token_in      token to correct
+    * @param  model_in      model with bigram counts to find the probability of each word given the previous token
+    * @param  editPenalty_in natural log of the probability lost to each edit, subtracted once per edit
+    * @param  location_in   location to store the words, highest score first
+    * @return 0 success
+    *******************/
+    int correct(std::string * previous_in, std::string * token_in, MLDocument<std::string> * model_in, double editPenalty_in,
+      std::vector<SpellCandidate> * location_in);
+
+    /*******************
+    * Finds the number of words in the index
+    * @return number of words
+    *******************/
+    int size();
+
+    /*******************
+    * Finds the number of bytes used by the deletes of every word
+    * @return bytes used by the deletes
+    *******************/
+    size_t memoryUsage();
+  };
+
+};
+
+#endif
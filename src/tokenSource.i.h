@@ -0,0 +1,36 @@
+/**************************************************************
+* Interface for anything a document can read its tokens from
+* one at a time, such as a file, a pipe or a generator
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _I_TOKENSOURCE
+#define _I_TOKENSOURCE
+
+#include "lexicon.h"
+
+//Token that marks the end of a sentence, read from text and closing generated sentences
+#define EOS "<END>"
+
+namespace nlp {
+
+  template <typename Type> class TokenSource {
+  public:
+    /******************
+    * Reads the next token from the source as its identifier in a lexicon
+    * @param  lexicon_in  lexicon to add new tokens to
+    * @param  location_in location to store the identifier
+    * @return 0 there are no tokens left
+    * @return 1 a token was read
+    ******************/
+    virtual int nextId(Lexicon<Type> * lexicon_in, TokenId * location_in) = 0;
+  };
+
+};
+
+#endif
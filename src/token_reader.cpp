@@ -0,0 +1,262 @@
+//Reads the word tokens of a file by mapping it into memory and scanning it in place
+
+#include <cstring> //strlen()
+
+#include "token_reader.h"
+
+#define TOKEN_CACHE_MIN_SIZE 1024
+
+namespace nlp {
+
+  /* Text every end of sentence token points at */
+  static const char eosText[] = EOS;
+
+  //Checks if a character is a letter
+  static inline bool isLetter(char character_in) {
+    return (character_in >= 'A' && character_in <= 'Z') || (character_in >= 'a' && character_in <= 'z');
+  }
+
+  //Checks if a character ends a sentence
+  static inline bool isSentenceEnd(char character_in) {
+    return character_in == '.' || character_in == '!' || character_in == '?' || character_in == '"';
+  }
+
+  //Makes a letter lowercase
+  static inline char toLower(char character_in) {
+    return (character_in >= 'A' && character_in <= 'Z') ? character_in + 32 : character_in;
+  }
+
+  //Finds the character of a token as it would be stored, only words are made lowercase
+  static inline char tokenCharacter(TokenView * token_in, int index_in) {
+    return token_in->text == eosText ? token_in->text[index_in] : toLower(token_in->text[index_in]);
+  }
+
+  //Creates a new reader for the words of a file
+  TokenReader::TokenReader(std::string fileName_in, bool eos_in) :TokenReader() {
+    open(fileName_in, eos_in);
+  }
+
+  //Maps a file into memory so its tokens can be read
+  int TokenReader::open(std::string fileName_in, bool eos_in) {
+    close();
+
+    //The file is read once from front to back
+    if (file.open(fileName_in, 1)) {
+      return -1;
+    }
+
+    data = file.getData();
+    size = file.getSize();
+    position = 0;
+    readEOS = eos_in;
+    pendingEOS = false;
+    lastWasEOS = false;
+
+    return 0;
+  }
+
+  //Unmaps the current file
+  int TokenReader::close() {
+    file.close();
+    data = NULL;
+    size = 0;
+    position = 0;
+    readEOS = false;
+
+    return 0;
+  }
+
+  //Checks if the reader has a file open
+  int TokenReader::isOpen() {
+    return data != NULL ? 1 : 0;
+  }
+
+  //Reads the next token of the file
+  int TokenReader::nextToken(TokenView * location_in) {
+    size_t start;
+
+    //A sentence end directly after the last word comes before anything else
+    if (pendingEOS) {
+      pendingEOS = false;
+      lastWasEOS = true;
+      location_in->text = eosText;
+      location_in->length = strlen(eosText);
+      return 1;
+    }
+
+    //Skip to the start of the next word, stopping at any sentence end
+    while (position < size && ! isLetter(data[position])) {
+      //Several sentence ends in a row only produce one token
+      if (readEOS && isSentenceEnd(data[position]) && ! lastWasEOS) {
+        ++position;
+        lastWasEOS = true;
+        location_in->text = eosText;
+        location_in->length = strlen(eosText);
+        return 1;
+      }
+      ++position;
+    }
+
+    //The end of the file ends the last sentence
+    if (position >= size) {
+      if (readEOS && ! lastWasEOS) {
+        lastWasEOS = true;
+        location_in->text = eosText;
+        location_in->length = strlen(eosText);
+        return 1;
+      }
+      return 0;
+    }
+
+    start = position;
+    while (position < size && isLetter(data[position])) {
+      ++position;
+    }
+    location_in->text = data + start;
+    location_in->length = position - start;
+
+    //The character ending the word is used up along with it
+    if (position < size) {
+      pendingEOS = readEOS && isSentenceEnd(data[position]);
+      ++position;
+    }
+    lastWasEOS = false;
+
+    return 1;
+  }
+
+  //Finds the identifier of a word through the cache, adding it to the lexicon if it is new
+  TokenId TokenReader::internToken(TokenView * token_in, Lexicon<std::string> * lexicon_in) {
+    std::vector<TokenId> oldCache;
+    unsigned long long hash;
+    size_t slot;
+    size_t mask;
+    int characterIterator;
+    std::string * current;
+    std::string word;
+    TokenId result;
+
+    //The cache only holds identifiers for the lexicon it was built with
+    if (lexicon_in != cachedLexicon || cache.empty()) {
+      cachedLexicon = lexicon_in;
+      cache.assign(TOKEN_CACHE_MIN_SIZE, UNKNOWN_TOKEN_ID);
+      numCached = 0;
+    }
+
+    //Hash the lowercase word without building it
+    hash = 0xCBF29CE484222325ull;
+    for (characterIterator = 0; characterIterator < token_in->length; ++characterIterator) {
+      hash = (hash ^ (unsigned char) tokenCharacter(token_in, characterIterator)) * 0x100000001B3ull;
+    }
+
+    mask = cache.size() - 1;
+    slot = hash & mask;
+    while (cache[slot] != UNKNOWN_TOKEN_ID) {
+      current = lexicon_in->getToken(cache[slot]);
+      if ((int) current->size() == token_in->length) {
+        for (characterIterator = 0; characterIterator < token_in->length; ++characterIterator) {
+          if ((*current)[characterIterator] != tokenCharacter(token_in, characterIterator)) {
+            break;
+          }
+        }
+        if (characterIterator == token_in->length) {
+          return cache[slot];
+        }
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    //Only words missing from the cache are copied out of the file
+    word.resize(token_in->length);
+    for (characterIterator = 0; characterIterator < token_in->length; ++characterIterator) {
+      word[characterIterator] = tokenCharacter(token_in, characterIterator);
+    }
+    result = lexicon_in->addToken(&word);
+    cache[slot] = result;
+    ++numCached;
+
+    //Keep the cache at most half full by moving every identifier to a larger cache
+    if (numCached * 2 > (int) cache.size()) {
+      oldCache.swap(cache);
+      cache.assign(oldCache.size() * 2, UNKNOWN_TOKEN_ID);
+      mask = cache.size() - 1;
+      for (slot = 0; slot < oldCache.size(); ++slot) {
+        if (oldCache[slot] == UNKNOWN_TOKEN_ID) {
+          continue;
+        }
+        current = lexicon_in->getToken(oldCache[slot]);
+        hash = 0xCBF29CE484222325ull;
+        for (characterIterator = 0; characterIterator < (int) current->size(); ++characterIterator) {
+          hash = (hash ^ (unsigned char) (*current)[characterIterator]) * 0x100000001B3ull;
+        }
+        hash = hash & mask;
+        while (cache[hash] != UNKNOWN_TOKEN_ID) {
+          hash = (hash + 1) & mask;
+        }
+        cache[hash] = oldCache[slot];
+      }
+    }
+
+    return result;
+  }
+
+  //Reads the next token of the file as its identifier in a lexicon
+  int TokenReader::nextId(Lexicon<std::string> * lexicon_in, TokenId * location_in) {
+    TokenView token;
+
+    if (! nextToken(&token)) {
+      return 0;
+    }
+    *location_in = internToken(&token, lexicon_in);
+
+    return 1;
+  }
+
+  //Reads every remaining token of the file as its identifier in a lexicon
+  int TokenReader::readIds(Lexicon<std::string> * lexicon_in, std::vector<TokenId> * location_in) {
+    TokenId current;
+    int result;
+
+    result = 0;
+    while (nextId(lexicon_in, &current)) {
+      location_in->push_back(current);
+      ++result;
+    }
+
+    return result;
+  }
+
+  //Reads every remaining token of the file as a lowercase string
+  int TokenReader::readTokens(std::vector<std::string> * location_in) {
+    TokenView token;
+    int characterIterator;
+    int result;
+
+    result = 0;
+    while (nextToken(&token)) {
+      location_in->push_back(std::string(token.text, token.length));
+      for (characterIterator = 0; characterIterator < token.length; ++characterIterator) {
+        location_in->back()[characterIterator] = tokenCharacter(&token, characterIterator);
+      }
+      ++result;
+    }
+
+    return result;
+  }
+
+  //Default constructor and destructor
+  TokenReader::TokenReader() {
+    data = NULL;
+    size = 0;
+    position = 0;
+    readEOS = false;
+    pendingEOS = false;
+    lastWasEOS = false;
+    cachedLexicon = NULL;
+    numCached = 0;
+  }
+  TokenReader::~TokenReader() {
+    close();
+  }
+
+};
@@ -0,0 +1,149 @@
+/**************************************************************
+* Reads the word tokens of a file by mapping it into memory
+* and scanning it in place. Follows the same rules as fileRead:
+* words are runs of letters made lowercase, and an end of
+* sentence token is produced at '.', '!', '?' and '"'
+*
+* Created By: Nick DelBen
+* Created On: October 18, 2026
+*
+* Last Edited: October 18, 2026
+*   - Created initially
+**************************************************************/
+
+#ifndef _H_TOKEN_READER
+#define _H_TOKEN_READER
+
+#include <string> //std::string
+#include <vector> //std::vector
+
+#include "lexicon.t.h"
+#include "tokenSource.i.h"
+#include "mapped_file.h"
+
+namespace nlp {
+
+  /* A token that points into the text it was read from rather than owning a copy */
+  struct TokenView {
+    /* First character of the token */
+    const char * text;
+
+    /* Number of characters in the token */
+    int length;
+  };
+
+  class TokenReader : public TokenSource<std::string> {
+  private:
+    /* The file being read */
+    MappedFile file;
+
+    /* The mapped contents of the file */
+    const char * data;
+
+    /* Number of bytes in the file */
+    size_t size;
+
+    /* Position of the next character to read */
+    size_t position;
+
+    /* Whether end of sentence tokens should be produced */
+    bool readEOS;
+
+    /* Whether an end of sentence was found directly after the last word */
+    bool pendingEOS;
+
+    /* Whether the last token produced was an end of sentence */
+    bool lastWasEOS;
+
+    /* Lexicon the identifier cache refers to */
+    Lexicon<std::string> * cachedLexicon;
+
+    /* Identifiers of words that have been interned, indexed by the hash of the word */
+    std::vector<TokenId> cache;
+
+    /* Number of identifiers in the cache */
+    int numCached;
+
+    /*******************
+    * Finds the identifier of a word through the cache, adding it to the lexicon if it is new
+    * @param  token_in    word to find the identifier of
+    * @param  lexicon_in  lexicon to add the word to
+    * @return identifier of the word
+    *******************/
+    TokenId internToken(TokenView * token_in, Lexicon<std::string> * lexicon_in);
+
+  public:
+    /*******************
+    * Creates a new reader for the words of a file
+    * @param fileName_in name of the file to read
+    * @param eos_in      whether end of sentence tokens should be produced
+    *******************/
+    TokenReader(std::string fileName_in, bool eos_in);
+
+    //Default constructor and destructor
+    TokenReader();
+    ~TokenReader();
+
+    //A reader owns its mapping so it can not be copied
+    TokenReader(const TokenReader & reader_in) = delete;
+    TokenReader & operator=(const TokenReader & reader_in) = delete;
+
+    /*******************
+    * Maps a file into memory so its tokens can be read
+    * @param  fileName_in name of the file to read
+    * @param  eos_in      whether end of sentence tokens should be produced
+    * @return 0  success
+    * @return -1 file could not be opened
+    *******************/
+    int open(std::string fileName_in, bool eos_in);
+
+    /*******************
+    * Unmaps the current file
+    * @return 0 success
+    *******************/
+    int close();
+
+    /*******************
+    * Checks if the reader has a file open
+    * @return 0 no file is open
+    * @return 1 a file is open
+    *******************/
+    int isOpen();
+
+    /*******************
+    * Reads the next token of the file. Words point at the bytes of the file so their
+    * letters keep the case they have in the file, end of sentence tokens point at EOS
+    * @param  location_in location to store the token
+    * @return 0 there are no tokens left
+    * @return 1 a token was read
+    *******************/
+    int nextToken(TokenView * location_in);
+
+    /*******************
+    * Reads the next token of the file as its identifier in a lexicon
+    * @param  lexicon_in  lexicon to add new words to
+    * @param  location_in location to store the identifier
+    * @return 0 there are no tokens left
+    * @return 1 a token was read
+    *******************/
+    int nextId(Lexicon<std::string> * lexicon_in, TokenId * location_in);
+
+    /*******************
+    * Reads every remaining token of the file as its identifier in a lexicon
+    * @param  lexicon_in  lexicon to add new words to
+    * @param  location_in location to append the identifiers to
+    * @return number of tokens read
+    *******************/
+    int readIds(Lexicon<std::string> * lexicon_in, std::vector<TokenId> * location_in);
+
+    /*******************
+    * Reads every remaining token of the file as a lowercase string
+    * @param  location_in location to append the tokens to
+    * @return number of tokens read
+    *******************/
+    int readTokens(std::vector<std::string> * location_in);
+  };
+
+};
+
+#endif